@@ -0,0 +1,288 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cstdint>
+#include <stdexcept>
+#include "../Trees/indexedMaxHeap.h"
+
+// Directed weighted graph in compressed sparse row form: the out-edges of
+// vertex u are targets[offsets[u] .. offsets[u + 1]) with matching weights.
+// Two flat arrays instead of a vector per vertex, so relaxing a vertex's
+// edges is one sequential scan.
+class CsrGraph {
+private:
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> targets;
+    std::vector<uint32_t> weights;
+
+public:
+    struct Edge {
+        uint32_t from, to, weight;
+    };
+
+    CsrGraph() {}
+
+    // Counting sort of the edges by source vertex.
+    CsrGraph(uint32_t vertices, const std::vector<Edge>& edges)
+        : offsets(vertices + 1, 0), targets(edges.size()), weights(edges.size()) {
+        for (const Edge& e : edges) {
+            if (e.from >= vertices || e.to >= vertices) {
+                throw std::out_of_range("Edge endpoint out of range");
+            }
+            offsets[e.from + 1]++;
+        }
+        for (uint32_t v = 0; v < vertices; v++) {
+            offsets[v + 1] += offsets[v];
+        }
+
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (const Edge& e : edges) {
+            uint32_t slot = fill[e.from]++;
+            targets[slot] = e.to;
+            weights[slot] = e.weight;
+        }
+    }
+
+    // Reads "from to weight" lines; vertex count is the largest id + 1.
+    // Blank lines are skipped; any other line that is not exactly three
+    // numbers is reported with its line number.
+    // With undirected set every edge is added in both directions.
+    static CsrGraph load(const std::string& path, bool undirected = false) {
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + path);
+        }
+
+        std::vector<Edge> edges;
+        uint32_t vertices = 0;
+        std::string line;
+        size_t lineNo = 0;
+        while (std::getline(in, line)) {
+            lineNo++;
+            if (line.find_first_not_of(" \t\r") == std::string::npos) {
+                continue;
+            }
+            std::istringstream fields(line);
+            Edge e;
+            std::string extra;
+            if (!(fields >> e.from >> e.to >> e.weight) || (fields >> extra)) {
+                throw std::runtime_error(path + ":" + std::to_string(lineNo) +
+                                         ": expected \"from to weight\"");
+            }
+            edges.push_back(e);
+            if (undirected) {
+                edges.push_back({e.to, e.from, e.weight});
+            }
+            vertices = std::max(vertices, std::max(e.from, e.to) + 1);
+        }
+        return CsrGraph(vertices, edges);
+    }
+
+    uint32_t vertexCount() const {
+        return offsets.empty() ? 0 : offsets.size() - 1;
+    }
+
+    size_t edgeCount() const {
+        return targets.size();
+    }
+
+    uint32_t begin(uint32_t v) const {
+        return offsets[v];
+    }
+
+    uint32_t end(uint32_t v) const {
+        return offsets[v + 1];
+    }
+
+    uint32_t target(uint32_t i) const {
+        return targets[i];
+    }
+
+    uint32_t weight(uint32_t i) const {
+        return weights[i];
+    }
+};
+
+// Single-threaded Dijkstra over a CsrGraph, using IndexedMaxHeap in min
+// mode so every vertex is in the queue at most once and improvements are
+// decrease-key updates. Working arrays are sized once per engine; only
+// the vertices touched by a query are reset afterwards, so a query that
+// stops early costs time proportional to what it explored, not to |V|.
+class DijkstraEngine {
+public:
+    static constexpr uint64_t Unreachable = std::numeric_limits<uint64_t>::max();
+
+private:
+    typedef IndexedMaxHeap<uint64_t, std::greater<uint64_t>, 4> Queue;
+    static constexpr size_t NoHandle = Queue::npos;
+
+    const CsrGraph& g;
+    Queue pq;
+    std::vector<uint64_t> dist;
+    std::vector<size_t> handleOf;       // vertex -> heap handle while queued
+    std::vector<uint32_t> vertexOf;     // heap handle -> vertex
+    std::vector<uint32_t> touched;
+
+    void reset() {
+        for (uint32_t v : touched) {
+            dist[v] = Unreachable;
+            handleOf[v] = NoHandle;
+        }
+        touched.clear();
+        pq.clear();
+    }
+
+public:
+    DijkstraEngine(const CsrGraph& graph)
+        : g(graph), dist(graph.vertexCount(), Unreachable),
+          handleOf(graph.vertexCount(), NoHandle) {}
+
+    // Shortest distances from source. If target is given, the search stops
+    // as soon as target is settled and returns its distance (Unreachable if
+    // there is no path); without a target the return value is 0.
+    uint64_t run(uint32_t source, uint32_t target = UINT32_MAX) {
+        if (source >= g.vertexCount()) {
+            throw std::out_of_range("Source vertex out of range");
+        }
+        if (target != UINT32_MAX && target >= g.vertexCount()) {
+            throw std::out_of_range("Target vertex out of range");
+        }
+        reset();
+        dist[source] = 0;
+        touched.push_back(source);
+        size_t h = pq.push(0);
+        handleOf[source] = h;
+        if (h >= vertexOf.size()) {
+            vertexOf.resize(h + 1);
+        }
+        vertexOf[h] = source;
+
+        while (!pq.isEmpty()) {
+            uint64_t d = pq.getMax();
+            uint32_t u = vertexOf[pq.removeMax()];
+            handleOf[u] = NoHandle;
+            if (u == target) {
+                return d;
+            }
+
+            for (uint32_t i = g.begin(u); i < g.end(u); i++) {
+                uint32_t v = g.target(i);
+                uint64_t nd = d + g.weight(i);
+                if (nd >= dist[v]) {
+                    continue;
+                }
+
+                if (dist[v] == Unreachable) {
+                    touched.push_back(v);
+                }
+                dist[v] = nd;
+                if (handleOf[v] != NoHandle) {
+                    pq.update(handleOf[v], nd);
+                } else {
+                    h = pq.push(nd);
+                    handleOf[v] = h;
+                    if (h >= vertexOf.size()) {
+                        vertexOf.resize(h + 1);
+                    }
+                    vertexOf[h] = v;
+                }
+            }
+        }
+        return target == UINT32_MAX ? 0 : Unreachable;
+    }
+
+    uint64_t distance(uint32_t v) const {
+        return dist[v];
+    }
+};
+
+// Answers many independent single-pair queries on all cores. Each worker
+// owns a DijkstraEngine and pulls the next query index from a shared counter.
+std::vector<uint64_t> parallelQueries(const CsrGraph& g,
+                                      const std::vector<std::pair<uint32_t, uint32_t>>& queries,
+                                      unsigned threads = std::thread::hardware_concurrency()) {
+    // Checked here: an exception inside a worker would end the program.
+    for (const std::pair<uint32_t, uint32_t>& q : queries) {
+        if (q.first >= g.vertexCount() || (q.second != UINT32_MAX && q.second >= g.vertexCount())) {
+            throw std::out_of_range("Query vertex out of range");
+        }
+    }
+
+    std::vector<uint64_t> answers(queries.size());
+    std::atomic<size_t> next(0);
+    if (threads == 0) {
+        threads = 1;
+    }
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([&]() {
+            DijkstraEngine engine(g);
+            size_t i;
+            while ((i = next.fetch_add(1, std::memory_order_relaxed)) < queries.size()) {
+                answers[i] = engine.run(queries[i].first, queries[i].second);
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+    return answers;
+}
+
+int main(int argc, char* argv[]) {
+    CsrGraph g;
+    if (argc > 1) {
+        g = CsrGraph::load(argv[1]);
+    } else {
+        // Random road-network-like graph: a ring plus short random chords.
+        const uint32_t n = 200000;
+        std::mt19937 gen(1);
+        std::vector<CsrGraph::Edge> edges;
+        for (uint32_t v = 0; v < n; v++) {
+            edges.push_back({v, (v + 1) % n, 1 + (uint32_t)(gen() % 100)});
+            edges.push_back({(v + 1) % n, v, 1 + (uint32_t)(gen() % 100)});
+            for (int k = 0; k < 3; k++) {
+                edges.push_back({v, (uint32_t)((v + gen() % 1000) % n), 1 + (uint32_t)(gen() % 100)});
+            }
+        }
+        g = CsrGraph(n, edges);
+    }
+    std::cout << "Graph: " << g.vertexCount() << " vertices, " << g.edgeCount() << " edges" << std::endl;
+
+    DijkstraEngine engine(g);
+    engine.run(0);
+    std::cout << "Full run from 0: distance to " << g.vertexCount() / 2 << " = "
+              << engine.distance(g.vertexCount() / 2) << std::endl;
+    std::cout << "Early-exit query 0 -> " << g.vertexCount() / 2 << " = "
+              << engine.run(0, g.vertexCount() / 2) << std::endl;
+
+    std::mt19937 gen(2);
+    std::vector<std::pair<uint32_t, uint32_t>> queries;
+    for (int i = 0; i < 2000; i++) {
+        uint32_t s = gen() % g.vertexCount();
+        queries.push_back({s, (uint32_t)((s + gen() % 5000) % g.vertexCount())});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<uint64_t> answers = parallelQueries(g, queries);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << queries.size() << " queries in " << secs * 1000 << " ms ("
+              << (long)(queries.size() / secs * 60) << " per minute)" << std::endl;
+
+    bool ok = true;
+    for (int i = 0; i < 20; i++) {
+        ok = ok && engine.run(queries[i].first, queries[i].second) == answers[i];
+    }
+    std::cout << (ok ? "Parallel answers match" : "MISMATCH") << std::endl;
+
+    return 0;
+}
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <stack>
+#include <vector>
+#include <chrono>
+#include <utility>
 
 class Queue {
 private:
@@ -8,13 +11,9 @@ private:
 
 public:
     void enqueue(int x) {
-        // Move all elements from stack2 to stack1
-        while (!stack2.empty()) {
-            stack1.push(stack2.top());
-            stack2.pop();
-        }
-
-        // Push the new element onto stack1
+        // New elements always go on stack1. Elements already moved to
+        // stack2 stay there until dequeued, so each element is moved at
+        // most once: amortized O(1) per operation.
         stack1.push(x);
     }
 
@@ -45,6 +44,178 @@ public:
     }
 };
 
+// Two-stack queue with worst-case O(1) per operation, for callers that
+// cannot afford the occasional O(n) transfer of the amortized version.
+//
+// front holds the oldest elements (oldest on top), rear the newest. As soon
+// as rear outgrows front, a rotation starts that builds the next front
+// stack incrementally (Hood-Melville / Okasaki real-time queue):
+//   1. pop rear onto next, reversing it (oldest of rear ends up on top),
+//   2. copy front's elements onto next from bottom to top.
+// Every operation performs a few steps of this work. Meanwhile dequeues
+// keep popping the old front and enqueues go to a fresh rear. Because
+// copying in step 2 starts from the bottom and dequeues take from the top,
+// the two never touch the same element; the copy stops where they meet.
+// Three steps per operation finish the rotation before front runs out.
+// Storage for the new stacks is reserved when a rotation starts, and the
+// old front is destroyed a few elements at a time, so no single call does
+// more than a constant amount of work.
+class RealTimeQueue {
+private:
+    std::vector<int> front;    // top = back() = oldest
+    std::vector<int> rear;     // top = back() = newest
+    std::vector<int> next;     // front under construction
+    std::vector<int> newRear;  // receives enqueues during a rotation
+    std::vector<int> spent;    // old front, destroyed incrementally
+    bool rotating = false;
+    size_t copied = 0;         // front elements already copied into next
+
+    static const int StepsPerOp = 3;
+
+    void startRotation() {
+        rotating = true;
+        copied = 0;
+        next.clear();
+        next.reserve(front.size() + rear.size());
+        newRear.clear();
+        newRear.reserve(front.size() + rear.size() + 2);
+    }
+
+    void step() {
+        if (!spent.empty()) {
+            spent.pop_back();
+        }
+        if (!rotating) {
+            return;
+        }
+
+        if (!rear.empty()) {
+            next.push_back(rear.back());
+            rear.pop_back();
+        } else if (copied < front.size()) {
+            next.push_back(front[copied++]);
+        }
+
+        if (rear.empty() && copied == front.size()) {
+            // Done: next holds every live element, oldest on top.
+            spent.clear();
+            spent.swap(front);
+            front.swap(next);
+            rear.swap(newRear);
+            rotating = false;
+            copied = 0;
+        }
+    }
+
+    void work() {
+        for (int i = 0; i < StepsPerOp; i++) {
+            step();
+        }
+        if (!rotating && rear.size() > front.size()) {
+            startRotation();
+            step();
+        }
+    }
+
+public:
+    void enqueue(int x) {
+        if (rotating) {
+            newRear.push_back(x);
+        } else {
+            rear.push_back(x);
+        }
+        work();
+    }
+
+    int dequeue() {
+        if (isEmpty()) {
+            std::cout << "Queue is empty. Cannot dequeue element.\n";
+            return -1;
+        }
+
+        if (front.empty() || (rotating && front.size() == copied)) {
+            // Only reachable when a rotation has not started yet (a lone
+            // element in rear); finish it now, it is a single step.
+            if (!rotating) {
+                startRotation();
+            }
+            while (rotating) {
+                step();
+            }
+        }
+
+        int dequeuedValue = front.back();
+        front.pop_back();
+        work();
+        return dequeuedValue;
+    }
+
+    bool isEmpty() {
+        size_t pending = rotating ? next.size() + rear.size() + newRear.size() + (front.size() - copied)
+                                  : front.size() + rear.size();
+        return pending == 0;
+    }
+};
+
+// The previous Queue, kept for the benchmark: enqueue poured stack2 back
+// into stack1 every time, so alternating enqueue/dequeue cost O(n) each.
+class PouringQueue {
+private:
+    std::stack<int> stack1;
+    std::stack<int> stack2;
+
+public:
+    void enqueue(int x) {
+        while (!stack2.empty()) {
+            stack1.push(stack2.top());
+            stack2.pop();
+        }
+        stack1.push(x);
+    }
+
+    int dequeue() {
+        if (stack2.empty()) {
+            while (!stack1.empty()) {
+                stack2.push(stack1.top());
+                stack1.pop();
+            }
+        }
+        int dequeuedValue = stack2.top();
+        stack2.pop();
+        return dequeuedValue;
+    }
+};
+
+// Keeps n elements queued and then alternates enqueue/dequeue ops times.
+// Returns total milliseconds and the slowest single operation in microseconds.
+template <typename Q>
+std::pair<double, double> benchmark(int n, int ops) {
+    typedef std::chrono::steady_clock Clock;
+    Q q;
+    for (int i = 0; i < n; i++) {
+        q.enqueue(i);
+    }
+
+    double worst = 0;
+    long long sum = 0;
+    Clock::time_point start = Clock::now();
+    for (int i = 0; i < ops; i++) {
+        Clock::time_point t0 = Clock::now();
+        q.enqueue(n + i);
+        sum += q.dequeue();
+        double us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        if (us > worst) {
+            worst = us;
+        }
+    }
+    double total = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+    if (sum != (long long)ops * (ops - 1) / 2) {
+        std::cout << "Wrong dequeue order!\n";
+    }
+    return std::make_pair(total, worst);
+}
+
 int main() {
     Queue queue;
 
@@ -66,5 +237,17 @@ int main() {
         std::cout << "Queue is not empty\n";
     }
 
+    // Alternating enqueue/dequeue with n elements standing in the queue.
+    for (int n : {1000, 10000, 30000}) {
+        const int ops = 20000;
+        std::pair<double, double> oldQ = benchmark<PouringQueue>(n, ops);
+        std::pair<double, double> amortized = benchmark<Queue>(n, ops);
+        std::pair<double, double> realTime = benchmark<RealTimeQueue>(n, ops);
+        std::cout << "n = " << n << ", " << ops << " enqueue+dequeue pairs\n";
+        std::cout << "  old Queue:     " << oldQ.first << " ms (worst op " << oldQ.second << " us)\n";
+        std::cout << "  Queue:         " << amortized.first << " ms (worst op " << amortized.second << " us)\n";
+        std::cout << "  RealTimeQueue: " << realTime.first << " ms (worst op " << realTime.second << " us)\n";
+    }
+
     return 0;
 }
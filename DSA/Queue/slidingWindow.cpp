@@ -0,0 +1,216 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <functional>
+#include <numeric>
+#include <algorithm>
+#include <climits>
+#include <utility>
+#include <stdexcept>
+
+// Sliding-window aggregator (two-stack SWAG).
+//
+// Same two-stack queue as Queue in queueUsingStack.cpp, but every element
+// on the front stack also stores the aggregate of itself and everything
+// below it, and the back stack keeps one running aggregate of all its
+// elements. The window aggregate is then combine(front top, back total):
+// O(1), and push/pop stay amortized O(1) because each element is moved
+// from back to front at most once.
+//
+// Works for any associative combine with an identity (a monoid): sum, min,
+// max, gcd, matrix product, ... It does not need to be commutative or
+// invertible; the window is always combined oldest to newest.
+template <typename T, typename Combine>
+class SlidingWindow {
+private:
+    struct Entry {
+        T value;
+        T agg;   // combine(value, everything below it = newer elements)
+    };
+
+    std::vector<Entry> front;   // top = back() = oldest
+    std::vector<T> back;        // top = back() = newest
+    T backAgg;                  // combine of back, oldest to newest
+    T identity;
+    Combine combine;
+
+    // Moves back onto front, newest first, so the oldest ends up on top.
+    void transfer() {
+        front.reserve(front.size() + back.size());
+        while (!back.empty()) {
+            T& v = back.back();
+            T agg = front.empty() ? v : combine(v, front.back().agg);
+            front.push_back(Entry{std::move(v), std::move(agg)});
+            back.pop_back();
+        }
+        backAgg = identity;
+    }
+
+public:
+    SlidingWindow(T identity, Combine combine = Combine())
+        : backAgg(identity), identity(identity), combine(combine) {}
+
+    void push(const T& x) {
+        backAgg = combine(backAgg, x);
+        back.push_back(x);
+    }
+
+    // Drops the oldest element; does nothing on an empty window.
+    void pop() {
+        if (front.empty()) {
+            if (back.empty()) {
+                return;
+            }
+            transfer();
+        }
+        front.pop_back();
+    }
+
+    // Aggregate of the whole window, identity when empty.
+    T query() const {
+        if (front.empty()) {
+            return backAgg;
+        }
+        return combine(front.back().agg, backAgg);
+    }
+
+    const T& oldest() {
+        if (isEmpty()) {
+            throw std::out_of_range("Window is empty");
+        }
+        if (front.empty()) {
+            transfer();
+        }
+        return front.back().value;
+    }
+
+    size_t size() const {
+        return front.size() + back.size();
+    }
+
+    bool isEmpty() const {
+        return front.empty() && back.empty();
+    }
+};
+
+struct Min {
+    int operator()(int a, int b) const { return std::min(a, b); }
+};
+
+struct Max {
+    int operator()(int a, int b) const { return std::max(a, b); }
+};
+
+struct Gcd {
+    long long operator()(long long a, long long b) const { return std::gcd(a, b); }
+};
+
+// Not commutative: composing x -> a*x + b maps, applied oldest first.
+struct Affine {
+    long long a, b;
+};
+
+struct Compose {
+    static const long long Mod = 1000000007;
+    Affine operator()(const Affine& f, const Affine& g) const {
+        // g(f(x)) = g.a * (f.a * x + f.b) + g.b
+        return Affine{g.a * f.a % Mod, (g.a * f.b + g.b) % Mod};
+    }
+};
+
+// Rolling minimum over the last w readings, recomputed from scratch each time,
+// as the metrics code does today.
+long long naiveRolling(const std::vector<int>& data, size_t w) {
+    std::deque<int> window;
+    long long check = 0;
+    for (int x : data) {
+        window.push_back(x);
+        if (window.size() > w) {
+            window.pop_front();
+        }
+        int m = INT_MAX;
+        for (int v : window) {
+            m = std::min(m, v);
+        }
+        check += m;
+    }
+    return check;
+}
+
+long long swagRolling(const std::vector<int>& data, size_t w) {
+    SlidingWindow<int, Min> window(INT_MAX);
+    long long check = 0;
+    for (int x : data) {
+        window.push(x);
+        if (window.size() > w) {
+            window.pop();
+        }
+        check += window.query();
+    }
+    return check;
+}
+
+int main() {
+    std::vector<int> readings = {5, 1, 4, 7, 3, 8, 2, 6, 9, 0};
+    const size_t w = 3;
+
+    SlidingWindow<int, std::plus<int>> sum(0);
+    SlidingWindow<int, Min> mn(INT_MAX);
+    SlidingWindow<int, Max> mx(INT_MIN);
+    std::cout << "window of " << w << ": sum min max\n";
+    for (int x : readings) {
+        sum.push(x);
+        mn.push(x);
+        mx.push(x);
+        if (sum.size() > w) {
+            sum.pop();
+            mn.pop();
+            mx.pop();
+        }
+        std::cout << "  +" << x << ": " << sum.query() << " " << mn.query() << " " << mx.query() << "\n";
+    }
+
+    SlidingWindow<long long, Gcd> g(0);
+    for (long long x : {12, 18, 30, 7, 14, 21}) {
+        g.push(x);
+        if (g.size() > 3) {
+            g.pop();
+        }
+        std::cout << "gcd of last 3 after " << x << ": " << g.query() << "\n";
+    }
+
+    // Custom monoid: the composition of the last 3 affine maps, applied to 1.
+    SlidingWindow<Affine, Compose> maps(Affine{1, 0});
+    Affine fs[] = {{2, 1}, {3, 0}, {1, 5}, {2, 2}};
+    for (const Affine& f : fs) {
+        maps.push(f);
+        if (maps.size() > 3) {
+            maps.pop();
+        }
+        Affine c = maps.query();
+        std::cout << "composed maps at x = 1: " << (c.a + c.b) % Compose::Mod << "\n";
+    }
+
+    // Rolling minimum over a long stream, against the from-scratch version.
+    std::vector<int> data(200000);
+    unsigned seed = 12345;
+    for (int& x : data) {
+        seed = seed * 1103515245 + 12345;
+        x = (int)(seed >> 8) % 1000000;
+    }
+    typedef std::chrono::steady_clock Clock;
+    for (size_t window : {16, 256, 4096}) {
+        Clock::time_point t0 = Clock::now();
+        long long a = naiveRolling(data, window);
+        Clock::time_point t1 = Clock::now();
+        long long b = swagRolling(data, window);
+        Clock::time_point t2 = Clock::now();
+        std::cout << "window " << window << ": recompute "
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms, SlidingWindow "
+                  << std::chrono::duration<double, std::milli>(t2 - t1).count() << " ms"
+                  << (a == b ? "" : " (MISMATCH)") << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+#include <iostream>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <new>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+// Lock-free single-producer/single-consumer ring buffer.
+//
+// Unlike the fixed array Queue in simple.cpp it is circular, so slots are
+// reused after being drained, and it never prints. Capacity is rounded up
+// to a power of two so an index maps to a slot with a mask. head and tail
+// only ever grow; tail - head is the number of queued items.
+//
+// The producer owns tail and the consumer owns head, each on its own cache
+// line. Each side also keeps a private copy of the other side's index and
+// only re-reads the shared one when the copy says the queue looks full
+// (producer) or empty (consumer), so in steady state the two cores hardly
+// touch each other's lines.
+template <typename T>
+class SpscQueue {
+private:
+    static const size_t CacheLine = 64;
+
+    T* slots;
+    size_t mask;
+
+    alignas(CacheLine) std::atomic<size_t> head;   // next slot to read
+    size_t cachedTail;                             // consumer's copy of tail
+
+    alignas(CacheLine) std::atomic<size_t> tail;   // next slot to write
+    size_t cachedHead;                             // producer's copy of head
+
+    static size_t roundUp(size_t n) {
+        size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // Free slots as seen by the producer, refreshing head only if needed.
+    size_t freeSlots(size_t t, size_t wanted) {
+        size_t capacity = mask + 1;
+        if (capacity - (t - cachedHead) < wanted) {
+            cachedHead = head.load(std::memory_order_acquire);
+        }
+        return capacity - (t - cachedHead);
+    }
+
+    // Queued items as seen by the consumer, refreshing tail only if needed.
+    size_t usedSlots(size_t h, size_t wanted) {
+        if (cachedTail - h < wanted) {
+            cachedTail = tail.load(std::memory_order_acquire);
+        }
+        return cachedTail - h;
+    }
+
+public:
+    SpscQueue(size_t capacity)
+        : mask(roundUp(capacity ? capacity : 1) - 1),
+          head(0), cachedTail(0), tail(0), cachedHead(0) {
+        slots = std::allocator<T>().allocate(mask + 1);   // raw, unconstructed
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    ~SpscQueue() {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_relaxed);
+        for (; h != t; h++) {
+            slots[h & mask].~T();
+        }
+        std::allocator<T>().deallocate(slots, mask + 1);
+    }
+
+    // Producer side.
+    template <typename U>
+    bool try_push(U&& value) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (freeSlots(t, 1) == 0) {
+            return false;
+        }
+        new (&slots[t & mask]) T(std::forward<U>(value));
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Copies as many of items[0..n) as fit and publishes them with a
+    // single store. Returns how many were pushed.
+    size_t try_push_n(const T* items, size_t n) {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t room = freeSlots(t, n);
+        if (n > room) {
+            n = room;
+        }
+        for (size_t i = 0; i < n; i++) {
+            new (&slots[(t + i) & mask]) T(items[i]);
+        }
+        if (n > 0) {
+            tail.store(t + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Consumer side.
+    bool try_pop(T& out) {
+        size_t h = head.load(std::memory_order_relaxed);
+        if (usedSlots(h, 1) == 0) {
+            return false;
+        }
+        T& slot = slots[h & mask];
+        out = std::move(slot);
+        slot.~T();
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Moves up to max items into out, releasing their slots with a single
+    // store. Returns how many were popped.
+    size_t try_pop_n(T* out, size_t max) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t n = usedSlots(h, max);
+        if (n > max) {
+            n = max;
+        }
+        for (size_t i = 0; i < n; i++) {
+            T& slot = slots[(h + i) & mask];
+            out[i] = std::move(slot);
+            slot.~T();
+        }
+        if (n > 0) {
+            head.store(h + n, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Approximate when called while the other side is running.
+    size_t size() const {
+        return tail.load(std::memory_order_acquire) - head.load(std::memory_order_acquire);
+    }
+
+    bool isEmpty() const {
+        return size() == 0;
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+};
+
+int main() {
+    // Same sequence as simple.cpp, but the queue keeps working past 100 items.
+    SpscQueue<int> queue(4);
+    int x = 0;
+    for (int round = 0; round < 50; round++) {
+        queue.try_push(round * 3 + 1);
+        queue.try_push(round * 3 + 2);
+        queue.try_pop(x);
+        queue.try_pop(x);
+    }
+    std::cout << "Capacity " << queue.capacity() << ", last dequeued " << x << "\n";
+
+    // Thread-to-thread pipeline moving items in batches of 64.
+    const long long items = 20000000;
+    SpscQueue<long long> pipe(1024);
+
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&]() {
+        long long batch[64];
+        long long next = 0;
+        while (next < items) {
+            size_t n = 0;
+            while (n < 64 && next + (long long)n < items) {
+                batch[n] = next + n;
+                n++;
+            }
+            size_t done = 0;
+            while (done < n) {
+                size_t pushed = pipe.try_push_n(batch + done, n - done);
+                if (pushed == 0) {
+                    std::this_thread::yield();   // full: let the consumer run
+                }
+                done += pushed;
+            }
+            next += n;
+        }
+    });
+
+    long long sum = 0, received = 0;
+    long long buffer[64];
+    while (received < items) {
+        size_t n = pipe.try_pop_n(buffer, 64);
+        if (n == 0) {
+            std::this_thread::yield();   // empty: let the producer run
+        }
+        for (size_t i = 0; i < n; i++) {
+            sum += buffer[i];
+        }
+        received += n;
+    }
+    producer.join();
+
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << received << " items in " << secs * 1000 << " ms ("
+              << (long long)(received / secs / 1e6) << " M items/s)\n";
+    std::cout << (sum == items * (items - 1) / 2 ? "Checksum ok" : "MISMATCH") << "\n";
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <chrono>
+using namespace std;
+
+template <typename T>
+class BlockingQueue{//work queue that consumers can wait on instead of busy-polling
+private:
+	deque<T> items;
+	mutex m;
+	condition_variable notEmpty;
+	int sleepers;//consumers parked on notEmpty
+	bool closed;
+	atomic<size_t> count;//mirror of items.size() for lock-free spinning
+	long wakeups;//notify calls made, for the demo
+
+	static const int SpinTries=200;
+
+	//Short optimistic spin before parking: if work shows up within a few
+	//microseconds the consumer never pays for a sleep/wake round trip.
+	bool spinForWork(){
+		for(int i=0;i<SpinTries;i++){
+			if(count.load(memory_order_relaxed)>0){
+				return true;
+			}
+			if(i%16==15){
+				this_thread::yield();
+			}
+		}
+		return false;
+	}
+
+	//Takes up to max items; caller holds the lock. If work is left over and
+	//someone else is asleep, pass the wakeup on (producers only signal the
+	//empty -> non-empty transition, so this chain keeps all consumers busy).
+	size_t take(vector<T>& out,size_t max){
+		size_t n=0;
+		while(n<max && !items.empty()){
+			out.push_back(move(items.front()));
+			items.pop_front();
+			n++;
+		}
+		count.store(items.size(),memory_order_relaxed);
+		if(!items.empty() && sleepers>0){
+			wakeups++;
+			notEmpty.notify_one();
+		}
+		return n;
+	}
+
+public:
+	BlockingQueue(){
+		sleepers=0;
+		closed=false;
+		count=0;
+		wakeups=0;
+	}
+
+	void enqueue(const T& obj){
+		bool wake;
+		{
+			lock_guard<mutex> lock(m);
+			wake=items.empty() && sleepers>0;
+			items.push_back(obj);
+			count.store(items.size(),memory_order_relaxed);
+			if(wake){
+				wakeups++;
+			}
+		}
+		if(wake){
+			notEmpty.notify_one();
+		}
+	}
+
+	void enqueueBatch(const vector<T>& batch){
+		bool wake;
+		{
+			lock_guard<mutex> lock(m);
+			wake=items.empty() && sleepers>0 && !batch.empty();
+			items.insert(items.end(),batch.begin(),batch.end());
+			count.store(items.size(),memory_order_relaxed);
+			if(wake){
+				wakeups++;
+			}
+		}
+		if(wake){
+			notEmpty.notify_one();
+		}
+	}
+
+	//Appends up to max items to out, waiting at most timeout for the first
+	//one. Returns how many were taken; 0 means timeout or closed and empty.
+	size_t dequeueBatch(vector<T>& out,size_t max,chrono::milliseconds timeout){
+		if(count.load(memory_order_relaxed)==0){
+			spinForWork();
+		}
+
+		unique_lock<mutex> lock(m);
+		if(items.empty() && !closed){
+			sleepers++;
+			notEmpty.wait_for(lock,timeout,[this](){
+				return !items.empty() || closed;
+			});
+			sleepers--;
+		}
+		return take(out,max);
+	}
+
+	bool dequeue(T& obj,chrono::milliseconds timeout){
+		vector<T> one;
+		if(dequeueBatch(one,1,timeout)==0){
+			return false;
+		}
+		obj=move(one[0]);
+		return true;
+	}
+
+	//Wakes every consumer; they drain what is left and then get 0.
+	void close(){
+		{
+			lock_guard<mutex> lock(m);
+			closed=true;
+		}
+		notEmpty.notify_all();
+	}
+
+	bool isClosed(){
+		lock_guard<mutex> lock(m);
+		return closed && items.empty();
+	}
+
+	long getWakeups(){
+		lock_guard<mutex> lock(m);
+		return wakeups;
+	}
+
+	size_t size(){
+		return count.load(memory_order_relaxed);
+	}
+};
+
+int main(){
+	BlockingQueue<int> q;
+	const int workers=4;
+	const int jobs=200000;
+	atomic<long> done(0);
+	atomic<long> sum(0);
+	atomic<long> batches(0);
+
+	vector<thread> pool;
+	for(int w=0;w<workers;w++){
+		pool.emplace_back([&](){
+			vector<int> batch;
+			while(true){
+				batch.clear();
+				if(q.dequeueBatch(batch,64,chrono::milliseconds(100))==0){
+					if(q.isClosed()){
+						return;
+					}
+					continue;//timed out, idle
+				}
+				long local=0;
+				for(int job:batch){
+					local+=job;
+				}
+				sum+=local;
+				done+=batch.size();
+				batches++;
+			}
+		});
+	}
+
+	//bursty producer: batches of jobs with pauses in between
+	auto start=chrono::steady_clock::now();
+	vector<int> burst;
+	for(int i=0;i<jobs;i++){
+		burst.push_back(i);
+		if(burst.size()==500){
+			q.enqueueBatch(burst);
+			burst.clear();
+			if(i%20000==19999){
+				this_thread::sleep_for(chrono::milliseconds(5));
+			}
+		}
+	}
+	q.enqueueBatch(burst);
+	q.close();
+	for(thread & t:pool){
+		t.join();
+	}
+	double ms=chrono::duration<double,milli>(chrono::steady_clock::now()-start).count();
+
+	cout<<"jobs done: "<<done<<" in "<<batches<<" batches, "<<ms<<" ms"<<endl;
+	cout<<"wakeups signalled: "<<q.getWakeups()<<endl;
+	cout<<(sum==(long)jobs*(jobs-1)/2?"checksum ok":"checksum MISMATCH")<<endl;
+}
@@ -1,4 +1,10 @@
 #include <iostream>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <vector>
+#include <functional>
+#include <string>
 using namespace std;
 
 template <typename T>
@@ -15,7 +21,100 @@ private:
 		return (i + 1) % cap;
 	}
 
+	// Copies k elements; one memcpy when T is trivially copyable.
+	static void copyN(T *dst, const T *src, int k)
+	{
+		if (k <= 0)
+			return;
+		if constexpr (is_trivially_copyable<T>::value)
+			memcpy(dst, src, k * sizeof(T));
+		else
+			copy(src, src + k, dst);
+	}
+
+	// Same, but for elements that are leaving their slots.
+	static void moveN(T *dst, T *src, int k)
+	{
+		if (k <= 0)
+			return;
+		if constexpr (is_trivially_copyable<T>::value)
+			memcpy(dst, src, k * sizeof(T));
+		else
+			move(src, src + k, dst);
+	}
+
+	// Grows (doubling) until at least extra more elements fit.
+	void reserveFor(int extra)
+	{
+		if (n + extra <= cap)
+			return;
+		int newCap = cap > 0 ? cap : 1;
+		while (newCap < n + extra)
+			newCap *= 2;
+		resize(newCap);
+	}
+
+	// Store into the slot before front / after rear; there must be room.
+	template <typename U>
+	void putFront(U &&obj)
+	{
+		if (empty())
+		{
+			front = rear = 0;
+		}
+		else
+		{
+			front = (front - 1 + cap) % cap;
+		}
+		eqptr[front] = forward<U>(obj);
+		n++;
+	}
+
+	template <typename U>
+	void putRear(U &&obj)
+	{
+		if (empty())
+		{
+			front = rear = 0;
+		}
+		else
+		{
+			rear = (rear + 1) % cap;
+		}
+		eqptr[rear] = forward<U>(obj);
+		n++;
+	}
+
+	// True if p points into the current array.
+	bool ownsPointer(const T *p)
+	{
+		return cap > 0 && less_equal<const T *>()(eqptr, p) && less<const T *>()(p, eqptr + cap);
+	}
+
+	// Moves count elements to the rear; the caller made room for them.
+	void moveToRear(T *items, int count)
+	{
+		if (count <= 0)
+			return;
+		if (empty())
+			front = 0;
+		int start = empty() ? 0 : next(rear);
+		int first = min(count, cap - start);
+		moveN(eqptr + start, items, first);
+		moveN(eqptr, items + first, count - first);
+		rear = (start + count - 1) % cap;
+		n += count;
+	}
+
 public:
+	// A contiguous run of queued elements. Because the array is circular
+	// the queue is at most two runs: [front, end of array) and [0, rear].
+	struct Segment
+	{
+		T *data;
+		int length;
+	};
+
 	EnhancedQueue()
 	{
 		eqptr = nullptr;
@@ -31,23 +130,18 @@ public:
 		front = rear = -1;
 	}
 
-	void enqueueAtFront(T &obj)
+	void enqueueAtFront(const T &obj)
 	{
 		if (n == cap)
 		{
-			// Queue is full, resize the array
-			resize(2 * cap);
-		}
-		if (empty())
-		{
-			front = rear = 0;
-		}
-		else
-		{
-			front = (front - 1 + cap) % cap;
+			// Queue is full, resize the array. obj may be one of our own
+			// elements (q.enqueueAtFront(q[0])), so copy it out first.
+			T copy = obj;
+			reserveFor(1);
+			putFront(move(copy));
+			return;
 		}
-		eqptr[front] = obj;
-		n++;
+		putFront(obj);
 	}
 
 	void dequeueAtFront()
@@ -67,23 +161,17 @@ public:
 		}
 	}
 
-	void enqueueAtRear(T &obj)
+	void enqueueAtRear(const T &obj)
 	{
 		if (n == cap)
 		{
-			// Queue is full, resize the array
-			resize(2 * cap);
-		}
-		if (empty())
-		{
-			front = rear = 0;
-		}
-		else
-		{
-			rear = (rear + 1) % cap;
+			// Queue is full, resize the array (same aliasing care as above)
+			T copy = obj;
+			reserveFor(1);
+			putRear(move(copy));
+			return;
 		}
-		eqptr[rear] = obj;
-		n++;
+		putRear(obj);
 	}
 
 	void dequeueAtRear()
@@ -103,6 +191,157 @@ public:
 		}
 	}
 
+	// Appends count elements at the rear with at most two block copies.
+	void enqueueRearN(const T *items, int count)
+	{
+		if (count <= 0)
+			return;
+		if (n + count > cap && ownsPointer(items))
+		{
+			// items lie in the array that the resize below frees
+			vector<T> copy(items, items + count);
+			enqueueRearN(copy.data(), count);
+			return;
+		}
+		reserveFor(count);
+		if (empty())
+			front = 0;
+		int start = empty() ? 0 : next(rear);
+		int first = min(count, cap - start);
+		copyN(eqptr + start, items, first);
+		copyN(eqptr, items + first, count - first);
+		rear = (start + count - 1) % cap;
+		n += count;
+	}
+
+	void enqueueRearN(const vector<T> &items)
+	{
+		enqueueRearN(items.data(), (int)items.size());
+	}
+
+	// Moves up to maxCount elements from the front into out and returns how
+	// many were taken, again with at most two block copies.
+	int dequeueFrontN(T *out, int maxCount)
+	{
+		int k = min(maxCount, n);
+		if (k <= 0)
+			return 0;
+		int first = min(k, cap - front);
+		moveN(out, eqptr + front, first);
+		moveN(out + first, eqptr, k - first);
+		front = (front + k) % cap;
+		n -= k;
+		if (n == 0)
+		{
+			front = rear = -1;
+		}
+		int newCap = cap;
+		while (newCap > 1 && n <= newCap / 4)
+			newCap /= 2;
+		if (newCap != cap)
+		{
+			// Queue is quarter full (or less), shrink the array
+			resize(newCap);
+		}
+		return k;
+	}
+
+	// i = 0 is the front element.
+	T &operator[](int i)
+	{
+		return eqptr[(front + i) % cap];
+	}
+
+	// Fills segs with the queued elements in order and returns how many
+	// segments (0, 1 or 2) were used.
+	int segments(Segment segs[2])
+	{
+		if (empty())
+			return 0;
+		int first = min(n, cap - front);
+		segs[0].data = eqptr + front;
+		segs[0].length = first;
+		if (first == n)
+			return 1;
+		segs[1].data = eqptr;
+		segs[1].length = n - first;
+		return 2;
+	}
+
+	// Reverses the first k elements in place (what modifyQueue in
+	// 138_Reverse_K_Q.cpp does with a stack and a second queue): k/2 swaps
+	// of slots modulo cap, no allocation.
+	void reverse_front(int k)
+	{
+		k = min(k, n);
+		for (int i = 0, j = k - 1; i < j; i++, j--)
+			swap(eqptr[(front + i) % cap], eqptr[(front + j) % cap]);
+	}
+
+	// Moves the first k elements to the rear, in order (negative k moves
+	// the last -k to the front). A full array only needs front and rear
+	// shifted; otherwise each element moves once into the free slot after
+	// rear, which leaves a free slot behind at the front. O(min(k, n)).
+	void rotate(int k)
+	{
+		if (n < 2)
+			return;
+		k %= n;
+		if (k < 0)
+			k += n;
+		if (k == 0)
+			return;
+		if (n == cap)
+		{
+			front = (front + k) % cap;
+			rear = (rear + k) % cap;
+			return;
+		}
+		if (k <= n - k)
+		{
+			for (int i = 0; i < k; i++)
+			{
+				rear = next(rear);
+				eqptr[rear] = move(eqptr[front]);
+				front = next(front);
+			}
+		}
+		else
+		{
+			for (int i = 0; i < n - k; i++)
+			{
+				front = (front - 1 + cap) % cap;
+				eqptr[front] = move(eqptr[rear]);
+				rear = (rear - 1 + cap) % cap;
+			}
+		}
+	}
+
+	// Appends all of other's elements and leaves other empty (its array is
+	// kept for reuse). Allocates only if this queue lacks room for them;
+	// an empty queue just trades arrays with other.
+	void splice(EnhancedQueue &other)
+	{
+		if (&other == this || other.empty())
+			return;
+		if (empty() && other.n > cap)
+		{
+			swap(eqptr, other.eqptr);
+			swap(front, other.front);
+			swap(rear, other.rear);
+			swap(n, other.n);
+			swap(cap, other.cap);
+			return;
+		}
+		reserveFor(other.n);
+		Segment segs[2];
+		int count = other.segments(segs);
+		for (int i = 0; i < count; i++)
+			moveToRear(segs[i].data, segs[i].length);
+		other.front = other.rear = -1;
+		other.n = 0;
+	}
+
 	T peekFront()
 	{
 		if (empty())
@@ -130,9 +369,11 @@ public:
 	void resize(int newCap)
 	{
 		T *newArr = new T[newCap];
-		for (int i = 0; i < n; i++)
+		if (n > 0)
 		{
-			newArr[i] = eqptr[(front + i) % cap];
+			int first = min(n, cap - front);
+			moveN(newArr, eqptr + front, first);
+			moveN(newArr + first, eqptr, n - first);
 		}
 		delete[] eqptr;
 		eqptr = newArr;
@@ -161,6 +402,67 @@ int main()
 	cout << "Front element: " << eq.peekFront() << endl;
 	cout << "Rear element: " << eq.peekRear() << endl;
 
+	// Batch traffic: push packets in bursts, drain in bursts.
+	int packets[256];
+	for (int i = 0; i < 256; i++)
+		packets[i] = 100 + i;
+	eq.enqueueRearN(packets, 256);
+	cout << "After a 256-element burst, size: " << eq.size() << ", element 3: " << eq[3] << endl;
+
+	int out[64];
+	int got = eq.dequeueFrontN(out, 64);
+	cout << "Dequeued " << got << " elements, first three: " << out[0] << " " << out[1] << " " << out[2] << endl;
+
+	EnhancedQueue<int>::Segment segs[2];
+	int count = eq.segments(segs);
+	cout << "Remaining elements lie in " << count << " contiguous segment(s):";
+	for (int i = 0; i < count; i++)
+		cout << " [" << segs[i].data[0] << " .. " << segs[i].data[segs[i].length - 1] << "]";
+	cout << endl;
+
+	// Enqueueing the queue's own elements while it has to grow.
+	EnhancedQueue<string> names(2);
+	names.enqueueAtRear("ann");
+	names.enqueueAtRear("bob");
+	names.enqueueAtRear(names[0]);
+	names.enqueueAtFront(names[2]);
+	EnhancedQueue<string>::Segment nameSegs[2];
+	names.segments(nameSegs);
+	names.enqueueRearN(nameSegs[0].data, nameSegs[0].length);
+	cout << "Self-enqueued:";
+	for (int i = 0; i < names.size(); i++)
+		cout << " " << names[i];
+	cout << endl;
+
+	// In-place range operations on the ring.
+	EnhancedQueue<int> rq(8);
+	for (int i = 1; i <= 7; i++)
+		rq.enqueueAtRear(i);
+	for (int i = 0; i < 4; i++)
+		rq.dequeueAtFront();
+	for (int i = 8; i <= 10; i++)
+		rq.enqueueAtRear(i); // 5 6 7 8 | 9 10: front at slot 4, rear at slot 1
+	EnhancedQueue<int>::Segment rqSegs[2];
+	cout << "Ring of 8 holding 6 elements in " << rq.segments(rqSegs) << " segments" << endl;
+	rq.reverse_front(4);
+	cout << "reverse_front(4):";
+	for (int i = 0; i < rq.size(); i++)
+		cout << " " << rq[i];
+	cout << endl;
+	rq.rotate(2);
+	cout << "rotate(2):";
+	for (int i = 0; i < rq.size(); i++)
+		cout << " " << rq[i];
+	cout << endl;
+	EnhancedQueue<int> tail(4);
+	tail.enqueueAtRear(200);
+	tail.enqueueAtFront(100); // wraps too: 100 in slot 3, 200 in slot 0
+	rq.splice(tail);
+	cout << "splice:";
+	for (int i = 0; i < rq.size(); i++)
+		cout << " " << rq[i];
+	cout << " (other now has " << tail.size() << ")" << endl;
+
 	return 0;
 }
 
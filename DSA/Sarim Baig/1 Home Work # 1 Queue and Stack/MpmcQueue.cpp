@@ -0,0 +1,180 @@
+#include <iostream>
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <utility>
+using namespace std;
+
+template <typename T>
+class MpmcQueue{//bounded multi-producer/multi-consumer circular queue (Vyukov)
+private:
+	//Same ring idea as queue<T> in queue.cpp, but fixed capacity and every
+	//slot carries a sequence number that says whose turn it is:
+	//  seq == pos        slot is free for the producer that claims pos
+	//  seq == pos + 1    slot holds the item for the consumer that claims pos
+	//Producers and consumers each claim positions with one CAS on their own
+	//counter and then work on different slots, so there is no global lock.
+	struct Cell{
+		atomic<size_t> seq;
+		T data;
+	};
+
+	static const size_t CacheLine=64;
+
+	Cell * cells;
+	size_t mask;//capacity-1, capacity is a power of two
+
+	alignas(CacheLine) atomic<size_t> enqueuePos;
+	alignas(CacheLine) atomic<size_t> dequeuePos;
+
+	static size_t roundUp(size_t n){//utility function
+		size_t p=2;
+		while(p<n){
+			p<<=1;
+		}
+		return p;
+	}
+
+public:
+	MpmcQueue(size_t icap){
+		size_t cap=roundUp(icap);
+		cells=new Cell[cap];
+		mask=cap-1;
+		for(size_t i=0;i<cap;i++){
+			cells[i].seq.store(i,memory_order_relaxed);
+		}
+		enqueuePos.store(0,memory_order_relaxed);
+		dequeuePos.store(0,memory_order_relaxed);
+	}
+
+	MpmcQueue(const MpmcQueue &)=delete;
+	void operator=(const MpmcQueue &)=delete;
+
+	~MpmcQueue(){
+		delete [] cells;
+	}
+
+	bool try_enqueue(const T& obj){
+		Cell * cell;
+		size_t pos=enqueuePos.load(memory_order_relaxed);
+		while(true){
+			cell=&cells[pos&mask];
+			size_t seq=cell->seq.load(memory_order_acquire);
+			long dif=(long)seq-(long)pos;
+			if(dif==0){
+				//slot is free for this position, try to claim it
+				if(enqueuePos.compare_exchange_weak(pos,pos+1,memory_order_relaxed)){
+					break;
+				}
+			}else if(dif<0){
+				return false;//the consumer of the previous lap is not done: full
+			}else{
+				pos=enqueuePos.load(memory_order_relaxed);//another producer got it
+			}
+		}
+		cell->data=obj;
+		cell->seq.store(pos+1,memory_order_release);//hand it to the consumer
+		return true;
+	}
+
+	bool try_dequeue(T& obj){
+		Cell * cell;
+		size_t pos=dequeuePos.load(memory_order_relaxed);
+		while(true){
+			cell=&cells[pos&mask];
+			size_t seq=cell->seq.load(memory_order_acquire);
+			long dif=(long)seq-(long)(pos+1);
+			if(dif==0){
+				if(dequeuePos.compare_exchange_weak(pos,pos+1,memory_order_relaxed)){
+					break;
+				}
+			}else if(dif<0){
+				return false;//nothing published here yet: empty
+			}else{
+				pos=dequeuePos.load(memory_order_relaxed);
+			}
+		}
+		obj=move(cell->data);
+		cell->seq.store(pos+mask+1,memory_order_release);//free for the next lap
+		return true;
+	}
+
+	//blocking wrappers: spin briefly, then give the core away between tries
+	void enqueue(const T& obj){
+		for(int spins=0;!try_enqueue(obj);spins++){
+			if(spins>=64){
+				this_thread::yield();
+			}
+		}
+	}
+
+	T dequeue(){
+		T obj;
+		for(int spins=0;!try_dequeue(obj);spins++){
+			if(spins>=64){
+				this_thread::yield();
+			}
+		}
+		return obj;
+	}
+
+	size_t capacity(){
+		return mask+1;
+	}
+};
+
+//moves `items` values through the queue with `threads` producers and as
+//many consumers, returns millions of items per second
+double benchmark(int threads,long items){
+	MpmcQueue<long> q(1024);
+	atomic<long> sum(0);
+	long perThread=items/threads;
+	vector<thread> workers;
+
+	auto start=chrono::steady_clock::now();
+	for(int t=0;t<threads;t++){
+		workers.emplace_back([&q,t,perThread](){
+			for(long i=0;i<perThread;i++){
+				q.enqueue(t*perThread+i);
+			}
+		});
+		workers.emplace_back([&q,&sum,perThread](){
+			long local=0;
+			for(long i=0;i<perThread;i++){
+				local+=q.dequeue();
+			}
+			sum+=local;
+		});
+	}
+	for(thread & w:workers){
+		w.join();
+	}
+	double secs=chrono::duration<double>(chrono::steady_clock::now()-start).count();
+
+	long n=perThread*threads;
+	if(sum!=n*(n-1)/2){
+		cout<<"checksum MISMATCH"<<endl;
+	}
+	return n/secs/1e6;
+}
+
+int main(){
+	MpmcQueue<int> q1(4);
+	q1.try_enqueue(22);
+	q1.try_enqueue(33);
+	q1.try_enqueue(44);
+	q1.try_enqueue(55);
+	cout<<"fifth enqueue on a full queue: "<<(q1.try_enqueue(66)?"accepted":"rejected")<<endl;
+	int value;
+	while(q1.try_dequeue(value)){
+		cout<<value<<" ";
+	}
+	cout<<endl;
+
+	cout<<"hardware threads: "<<thread::hardware_concurrency()<<endl;
+	for(int threads=1;threads<=8;threads*=2){
+		cout<<threads<<" producers + "<<threads<<" consumers: "
+			<<benchmark(threads,4000000)<<" M items/s"<<endl;
+	}
+}
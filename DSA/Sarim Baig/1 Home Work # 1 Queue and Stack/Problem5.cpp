@@ -3,26 +3,170 @@
 #include <stack>
 #include <queue>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
 using namespace std;
 
 class Receiver
 {
     vector<queue<int>> sqn;
 
+    // One lock per resource, so submissions to different resources never
+    // wait for each other and the dispatcher only blocks one queue at a time.
+    vector<mutex> locks;
+
+    // Deficit round robin state, owned by the dispatcher thread (cost is
+    // also written by setCost, so it is guarded by locks[rid]).
+    vector<int> cost;     // service units one request at the resource takes
+    vector<int> deficit;  // units the resource may still spend this round
+    int quantum;          // units every backlogged resource earns per round
+    int maxBatch;         // requests handed to the handler in one call
+
+    struct Stats
+    {
+        long submitted = 0;
+        long served = 0;
+        long batches = 0;
+        size_t maxDepth = 0;
+    };
+    vector<Stats> stats;
+    chrono::steady_clock::time_point started;
+
+    void checkRid(int rid)
+    {
+        if (rid < 0 || rid >= (int)sqn.size())
+            throw out_of_range("no resource " + to_string(rid));
+    }
+
 public:
+    Receiver(int resources = 5, int quantum = 4, int maxBatch = 8)
+        : sqn(resources), locks(resources), cost(resources, 1), deficit(resources, 0),
+          quantum(quantum), maxBatch(maxBatch), stats(resources), started(chrono::steady_clock::now())
+    {
+    }
+
+    void setCost(int rid, int units)
+    {
+        checkRid(rid);
+        lock_guard<mutex> lock(locks[rid]);
+        cost[rid] = max(1, units);
+    }
+    // a resource whose requests cost more units gets proportionally fewer
+    // of them per round; a cost above the quantum is paid off over several
+    // rounds, since the deficit carries over while the queue is backlogged
+
     void addRequestforResource(int rid, int reqno)
     {
+        checkRid(rid);
+        lock_guard<mutex> lock(locks[rid]);
+        sqn[rid].push(reqno);
+        stats[rid].submitted++;
+        stats[rid].maxDepth = max(stats[rid].maxDepth, sqn[rid].size());
     }
     // adds a new quest with number reqno to the resource sqn[rid]
     // rid is between 0 and 4, as we have 5 resources
+    // safe to call from several threads at once
+
     void serviceRequestatResource(int rid)
     {
+        checkRid(rid);
+        lock_guard<mutex> lock(locks[rid]);
+        if (sqn[rid].empty())
+            return;
+        sqn[rid].pop();
+        stats[rid].served++;
+        stats[rid].batches++;
     }
     // services the request (dequeues) at front of sqn[rid]
+
+    int dispatchRound(const function<void(int rid, const vector<int> &batch)> &handler)
+    {
+        int served = 0;
+        vector<int> batch;
+        for (int rid = 0; rid < (int)sqn.size(); rid++)
+        {
+            batch.clear();
+            {
+                lock_guard<mutex> lock(locks[rid]);
+                if (sqn[rid].empty())
+                {
+                    deficit[rid] = 0; // idle resources do not bank credit
+                    continue;
+                }
+                deficit[rid] += quantum;
+                while (!sqn[rid].empty() && deficit[rid] >= cost[rid] && (int)batch.size() < maxBatch)
+                {
+                    batch.push_back(sqn[rid].front());
+                    sqn[rid].pop();
+                    deficit[rid] -= cost[rid];
+                }
+                if (sqn[rid].empty())
+                    deficit[rid] = 0;
+                else if ((int)batch.size() == maxBatch)
+                    deficit[rid] = min(deficit[rid], quantum); // cut short by the batch limit, not by cost
+                if (batch.empty())
+                    continue; // still saving up for one expensive request
+                stats[rid].served += batch.size();
+                stats[rid].batches++;
+            }
+            handler(rid, batch); // outside the lock, submitters keep going
+            served += batch.size();
+        }
+        return served;
+    }
+    // one deficit round robin pass: every backlogged resource earns quantum
+    // units and spends them on requests from its front, all taken in one
+    // batch; returns how many requests were handed to handler
+
+    int pending()
+    {
+        int total = 0;
+        for (int rid = 0; rid < (int)sqn.size(); rid++)
+        {
+            lock_guard<mutex> lock(locks[rid]);
+            total += sqn[rid].size();
+        }
+        return total;
+    }
+    // requests waiting in all queues
+
     void printQueues()
     {
+        for (int rid = 0; rid < (int)sqn.size(); rid++)
+        {
+            queue<int> copy;
+            {
+                lock_guard<mutex> lock(locks[rid]);
+                copy = sqn[rid];
+            }
+            while (!copy.empty())
+            {
+                cout << copy.front() << " ";
+                copy.pop();
+            }
+            cout << endl;
+        }
     }
     // prints all queues line by line, numbers separated by spaces
+
+    void printStats()
+    {
+        double secs = chrono::duration<double>(chrono::steady_clock::now() - started).count();
+        for (int rid = 0; rid < (int)sqn.size(); rid++)
+        {
+            lock_guard<mutex> lock(locks[rid]);
+            const Stats &st = stats[rid];
+            cout << "resource " << rid << ": submitted " << st.submitted << ", served " << st.served
+                 << " in " << st.batches << " batches (" << (long)(st.served / secs) << "/s), depth "
+                 << sqn[rid].size() << " now, " << st.maxDepth << " max" << endl;
+        }
+    }
+    // per-resource throughput since construction and queue depth
 };
 
 void SequenceCheck()
@@ -59,4 +203,66 @@ void SequenceCheck()
 int main()
 {
     SequenceCheck();
+
+    Receiver r;
+    r.addRequestforResource(0, 101);
+    r.addRequestforResource(0, 102);
+    r.addRequestforResource(2, 301);
+    r.addRequestforResource(4, 501);
+    r.serviceRequestatResource(0);
+    r.printQueues();
+
+    // Three clients flood resource 0 and trickle into the others; resource
+    // 3 is slow (3 units per request) and resource 4 slower still (9). The dispatcher keeps serving all of
+    // them in batches while the clients are still submitting.
+    Receiver rx(5, 6, 16);
+    rx.setCost(3, 3);
+    rx.setCost(4, 9); // more than the quantum: one request every other round
+    atomic<int> clientsLeft(3);
+    vector<thread> clients;
+    for (int c = 0; c < 3; c++)
+    {
+        clients.emplace_back([&rx, &clientsLeft, c]()
+        {
+            for (int i = 0; i < 100000; i++)
+            {
+                int reqno = c * 1000000 + i;
+                rx.addRequestforResource(i % 10 < 6 ? 0 : i % 5, reqno);
+            }
+            clientsLeft--;
+        });
+    }
+
+    vector<long> handled(5, 0);
+    long rounds = 0;
+    int firstServedRound[5] = {-1, -1, -1, -1, -1};
+    while (true)
+    {
+        bool last = clientsLeft == 0; // read before the round, so nothing is missed
+        int n = rx.dispatchRound([&](int rid, const vector<int> &batch)
+        {
+            handled[rid] += batch.size();
+            if (firstServedRound[rid] < 0)
+                firstServedRound[rid] = rounds;
+        });
+        rounds++;
+        if (n == 0)
+        {
+            if (last && rx.pending() == 0)
+                break;
+            this_thread::yield();
+        }
+    }
+    for (thread &t : clients)
+        t.join();
+
+    rx.printStats();
+    cout << rounds << " dispatcher rounds; first batch per resource in round";
+    for (int rid = 0; rid < 5; rid++)
+        cout << " " << firstServedRound[rid];
+    cout << endl;
+    long total = 0;
+    for (long h : handled)
+        total += h;
+    cout << (total == 300000 ? "all requests served" : "REQUESTS LOST") << endl;
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <chrono>
+#include <stdexcept>
+using namespace std;
+
+template <typename T>
+class SegmentedQueue//EnhancedQueue interface on fixed-size blocks instead of one array
+{
+private:
+	//EnhancedQueue::resize copies every element whenever the capacity
+	//doubles or halves. Here the elements live in blocks of BlockSize slots
+	//and only a small map of block pointers is ever reallocated, so an
+	//element never moves once it is enqueued (references stay valid) and
+	//no enqueue copies more than the map.
+	//Element i is at position head + i counted from the start of block
+	//map[mapBegin]; blocks map[mapBegin .. mapEnd) are in use.
+	static const int BlockBytes=4096;
+	static const int BlockSize=sizeof(T)>=BlockBytes/16 ? 16 : BlockBytes/sizeof(T);
+	static const int MaxSpare=8;
+
+	vector<T*> map;
+	int mapBegin, mapEnd;
+	int head;//offset of the front element inside map[mapBegin]
+	int n;
+	vector<T*> spare;//emptied blocks kept for reuse
+
+	T* getBlock()
+	{
+		if (!spare.empty())
+		{
+			T* b = spare.back();
+			spare.pop_back();
+			return b;
+		}
+		return allocator<T>().allocate(BlockSize);
+	}
+
+	void releaseBlock(T* b)
+	{
+		if (spare.size() < MaxSpare)
+			spare.push_back(b);
+		else
+			allocator<T>().deallocate(b, BlockSize);
+	}
+
+	//Makes room for one more block pointer at the front or at the back.
+	//Only pointers are copied; if the map is mostly free the used part is
+	//just re-centred in place.
+	void growMap(bool atFront)
+	{
+		int used = mapEnd - mapBegin;
+		int newSize = (int)map.size();
+		if (2 * (used + 1) > newSize)
+			newSize = max(8, 2 * newSize);
+
+		vector<T*> newMap(newSize, nullptr);
+		int newBegin = (newSize - used) / 2;
+		if (atFront && newBegin == 0)
+			newBegin = 1;
+		for (int i = 0; i < used; i++)
+			newMap[newBegin + i] = map[mapBegin + i];
+		map.swap(newMap);
+		mapBegin = newBegin;
+		mapEnd = newBegin + used;
+	}
+
+	T* slot(int i)
+	{
+		int pos = head + i;
+		return map[mapBegin + pos / BlockSize] + pos % BlockSize;
+	}
+
+	//Queue became empty: keep the blocks as spares and re-centre the map.
+	void reset()
+	{
+		while (mapBegin < mapEnd)
+			releaseBlock(map[mapBegin++]);
+		mapBegin = mapEnd = (int)map.size() / 2;
+		head = 0;
+	}
+
+	void destroyAll()
+	{
+		for (int i = 0; i < n; i++)
+			slot(i)->~T();
+		for (int b = mapBegin; b < mapEnd; b++)
+			allocator<T>().deallocate(map[b], BlockSize);
+		for (T* b : spare)
+			allocator<T>().deallocate(b, BlockSize);
+		spare.clear();
+	}
+
+public:
+	SegmentedQueue()
+	{
+		mapBegin = mapEnd = 0;
+		head = 0;
+		n = 0;
+	}
+
+	SegmentedQueue(const SegmentedQueue &) = delete;
+	void operator=(const SegmentedQueue &) = delete;
+
+	~SegmentedQueue()
+	{
+		destroyAll();
+	}
+
+	void enqueueAtFront(const T &obj)
+	{
+		if (head == 0 || mapBegin == mapEnd)
+		{
+			if (mapBegin == 0)
+				growMap(true);
+			map[--mapBegin] = getBlock();
+			head = BlockSize;
+		}
+		new (map[mapBegin] + head - 1) T(obj);
+		head--;
+		n++;
+	}
+
+	void enqueueAtRear(const T &obj)
+	{
+		int pos = head + n;
+		if (mapBegin + pos / BlockSize == mapEnd)
+		{
+			if (mapEnd == (int)map.size())
+				growMap(false);
+			map[mapEnd++] = getBlock();
+		}
+		new (slot(n)) T(obj);
+		n++;
+	}
+
+	void dequeueAtFront()
+	{
+		if (empty())
+			return;
+		slot(0)->~T();
+		head++;
+		n--;
+		if (n == 0)
+			reset();
+		else if (head == BlockSize)
+		{
+			releaseBlock(map[mapBegin++]);
+			head = 0;
+		}
+	}
+
+	void dequeueAtRear()
+	{
+		if (empty())
+			return;
+		slot(n - 1)->~T();
+		n--;
+		if (n == 0)
+			reset();
+		else if ((head + n) % BlockSize == 0)
+			releaseBlock(map[--mapEnd]);//the last block just became empty
+	}
+
+	T &peekFront()
+	{
+		if (empty())
+			throw runtime_error("Queue is empty");
+		return *slot(0);
+	}
+
+	T &peekRear()
+	{
+		if (empty())
+			throw runtime_error("Queue is empty");
+		return *slot(n - 1);
+	}
+
+	//O(1) random access, 0 is the front
+	T &operator[](int i)
+	{
+		return *slot(i);
+	}
+
+	int size()
+	{
+		return n;
+	}
+
+	bool empty()
+	{
+		return n == 0;
+	}
+};
+
+int main()
+{
+	SegmentedQueue<int> sq;
+
+	int value1 = 10;
+	int value2 = 20;
+	sq.enqueueAtRear(value1);
+	sq.enqueueAtRear(value2);
+	int value3 = 5;
+	sq.enqueueAtFront(value3);
+
+	cout << "Queue size: " << sq.size() << endl;
+	cout << "Front element: " << sq.peekFront() << endl;
+	cout << "Rear element: " << sq.peekRear() << endl;
+
+	//references stay valid while the queue grows by millions of elements
+	int &first = sq.peekFront();
+	typedef chrono::steady_clock Clock;
+	double worst = 0;
+	for (int i = 0; i < 5000000; i++)
+	{
+		Clock::time_point t0 = Clock::now();
+		if (i % 2)
+			sq.enqueueAtRear(i);
+		else
+			sq.enqueueAtFront(i);
+		double us = chrono::duration<double, micro>(Clock::now() - t0).count();
+		if (us > worst)
+			worst = us;
+	}
+	first = 7;
+	cout << "After 5M enqueues, the old front reads " << sq[2500000] << " through the queue" << endl;
+	cout << "Slowest single enqueue: " << worst << " us" << endl;
+
+	//expected order: even i newest first, then 7 10 20, then odd i oldest first
+	vector<int> expected;
+	for (int i = 4999998; i >= 0; i -= 2)
+		expected.push_back(i);
+	expected.push_back(7);
+	expected.push_back(10);
+	expected.push_back(20);
+	for (int i = 1; i < 5000000; i += 2)
+		expected.push_back(i);
+
+	bool ok = sq.size() == (int)expected.size();
+	size_t lo = 0, hi = expected.size();
+	while (ok && !sq.empty())
+	{
+		if (sq.size() % 3 == 0)
+		{
+			ok = sq.peekRear() == expected[--hi];
+			sq.dequeueAtRear();
+		}
+		else
+		{
+			ok = sq.peekFront() == expected[lo++];
+			sq.dequeueAtFront();
+		}
+	}
+	cout << (ok ? "Drained in order" : "ORDER MISMATCH") << endl;
+
+	return 0;
+}
@@ -0,0 +1,456 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include <type_traits>
+using namespace std;
+
+//Chase-Lev work-stealing deque (with the C11 memory orders of Le et al.).
+//Like EnhancedQueue it is a circular array used from both ends, but only
+//the owner thread works at the bottom (push/take, LIFO, no CAS unless one
+//item is left) and any other thread may steal from the top (FIFO, one
+//CAS). T must be trivially copyable; the pool stores task pointers.
+template <typename T>
+class ChaseLevDeque
+{
+private:
+	static_assert(is_trivially_copyable<T>::value, "ChaseLevDeque holds plain values such as pointers");
+
+	struct Ring
+	{
+		int64_t cap;//power of two
+		atomic<T> *slots;
+
+		Ring(int64_t icap)
+		{
+			cap = icap;
+			slots = new atomic<T>[icap];
+		}
+
+		~Ring()
+		{
+			delete[] slots;
+		}
+
+		T get(int64_t i)
+		{
+			return slots[i & (cap - 1)].load(memory_order_relaxed);
+		}
+
+		void put(int64_t i, T x)
+		{
+			slots[i & (cap - 1)].store(x, memory_order_relaxed);
+		}
+	};
+
+	static const int CacheLine = 64;
+
+	alignas(CacheLine) atomic<int64_t> top;//next item to steal
+	alignas(CacheLine) atomic<int64_t> bottom;//next free slot, owner only writes
+	atomic<Ring *> ring;
+	//Thieves may still read a ring after the owner replaced it, so old
+	//rings are kept until the deque dies (they add up to less than the
+	//current one).
+	vector<Ring *> retired;
+
+	Ring *grow(Ring *old, int64_t b, int64_t t)
+	{
+		Ring *bigger = new Ring(old->cap * 2);
+		for (int64_t i = t; i < b; i++)
+			bigger->put(i, old->get(i));
+		retired.push_back(old);
+		ring.store(bigger, memory_order_release);
+		return bigger;
+	}
+
+public:
+	ChaseLevDeque(int64_t icap = 64)
+	{
+		int64_t cap = 2;
+		while (cap < icap)
+			cap <<= 1;
+		top.store(0, memory_order_relaxed);
+		bottom.store(0, memory_order_relaxed);
+		ring.store(new Ring(cap), memory_order_relaxed);
+	}
+
+	ChaseLevDeque(const ChaseLevDeque &) = delete;
+	void operator=(const ChaseLevDeque &) = delete;
+
+	~ChaseLevDeque()
+	{
+		delete ring.load(memory_order_relaxed);
+		for (Ring *r : retired)
+			delete r;
+	}
+
+	//Owner only.
+	void push(T x)
+	{
+		int64_t b = bottom.load(memory_order_relaxed);
+		int64_t t = top.load(memory_order_acquire);
+		Ring *r = ring.load(memory_order_relaxed);
+		if (b - t > r->cap - 1)
+			r = grow(r, b, t);
+		r->put(b, x);
+		atomic_thread_fence(memory_order_release);
+		bottom.store(b + 1, memory_order_relaxed);
+	}
+
+	//Owner only: newest item, false if empty or a thief won the last one.
+	bool take(T &out)
+	{
+		int64_t b = bottom.load(memory_order_relaxed) - 1;
+		Ring *r = ring.load(memory_order_relaxed);
+		bottom.store(b, memory_order_relaxed);
+		atomic_thread_fence(memory_order_seq_cst);
+		int64_t t = top.load(memory_order_relaxed);
+		if (t > b)
+		{
+			bottom.store(b + 1, memory_order_relaxed);//was already empty
+			return false;
+		}
+		out = r->get(b);
+		if (t < b)
+			return true;//more than one left, no thief can reach this one
+		//Last item: race the thieves for it.
+		bool won = top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed);
+		bottom.store(b + 1, memory_order_relaxed);
+		return won;
+	}
+
+	//Any thread: oldest item, false if empty or another thread got it.
+	bool steal(T &out)
+	{
+		int64_t t = top.load(memory_order_acquire);
+		atomic_thread_fence(memory_order_seq_cst);
+		int64_t b = bottom.load(memory_order_acquire);
+		if (t >= b)
+			return false;
+		Ring *r = ring.load(memory_order_acquire);
+		T x = r->get(t);
+		if (!top.compare_exchange_strong(t, t + 1, memory_order_seq_cst, memory_order_relaxed))
+			return false;
+		out = x;
+		return true;
+	}
+
+	//Approximate while other threads are running.
+	int64_t size()
+	{
+		int64_t b = bottom.load(memory_order_relaxed);
+		int64_t t = top.load(memory_order_relaxed);
+		return b > t ? b - t : 0;
+	}
+};
+
+//Fork-join pool: every worker owns a ChaseLevDeque. spawn() pushes onto
+//the calling worker's own deque, so recursive jobs stay local and hot in
+//cache; idle workers steal the oldest (biggest) pieces from others. There
+//is no central queue except for tasks submitted from outside the pool.
+class WorkStealingPool
+{
+public:
+	//Counts the spawned tasks a sync() still has to wait for.
+	struct Join
+	{
+		atomic<int> pending;
+
+		Join()
+		{
+			pending.store(0, memory_order_relaxed);
+		}
+	};
+
+private:
+	struct Task
+	{
+		function<void()> fn;
+		Join *join;
+	};
+
+	struct Worker
+	{
+		ChaseLevDeque<Task *> tasks;
+		atomic<long> steals;
+		unsigned seed;
+	};
+
+	vector<unique_ptr<Worker>> workers;
+	vector<thread> threads;
+	mutex injectLock;
+	deque<Task *> injected;//tasks spawned by threads outside the pool
+	atomic<bool> stopping;
+
+	static thread_local WorkStealingPool *currentPool;
+	static thread_local int currentIndex;
+
+	static const int IdleSpins = 64;
+
+	void execute(Task *task)
+	{
+		task->fn();
+		task->join->pending.fetch_sub(1, memory_order_release);
+		delete task;
+	}
+
+	bool takeInjected(Task *&task)
+	{
+		lock_guard<mutex> lock(injectLock);
+		if (injected.empty())
+			return false;
+		task = injected.front();
+		injected.pop_front();
+		return true;
+	}
+
+	//One round of looking for work: own deque, then a random victim sweep,
+	//then the injection queue. self is -1 for threads outside the pool.
+	bool findTask(int self, Task *&task)
+	{
+		if (self >= 0 && workers[self]->tasks.take(task))
+			return true;
+
+		int count = (int)workers.size();
+		unsigned start = 0;
+		if (self >= 0)
+		{
+			unsigned &s = workers[self]->seed;
+			s = s * 1103515245 + 12345;
+			start = (s >> 16) % count;
+		}
+		for (int k = 0; k < count; k++)
+		{
+			int victim = (start + k) % count;
+			if (victim != self && workers[victim]->tasks.steal(task))
+			{
+				if (self >= 0)
+					workers[self]->steals.fetch_add(1, memory_order_relaxed);
+				return true;
+			}
+		}
+		return takeInjected(task);
+	}
+
+	void workerLoop(int self)
+	{
+		currentPool = this;
+		currentIndex = self;
+		int idle = 0;
+		while (!stopping.load(memory_order_acquire))
+		{
+			Task *task;
+			if (findTask(self, task))
+			{
+				execute(task);
+				idle = 0;
+			}
+			else if (++idle < IdleSpins)
+				this_thread::yield();
+			else
+				this_thread::sleep_for(chrono::microseconds(100));
+		}
+	}
+
+public:
+	WorkStealingPool(int threadCount = (int)thread::hardware_concurrency())
+	{
+		if (threadCount < 1)
+			threadCount = 1;
+		stopping.store(false);
+		for (int i = 0; i < threadCount; i++)
+		{
+			workers.emplace_back(new Worker());
+			workers.back()->steals.store(0);
+			workers.back()->seed = 2654435761u * (i + 1);
+		}
+		for (int i = 0; i < threadCount; i++)
+			threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+	}
+
+	WorkStealingPool(const WorkStealingPool &) = delete;
+	void operator=(const WorkStealingPool &) = delete;
+
+	//Callers must sync() everything they spawned first.
+	~WorkStealingPool()
+	{
+		stopping.store(true, memory_order_release);
+		for (thread &t : threads)
+			t.join();
+	}
+
+	template <typename F>
+	void spawn(Join &join, F &&fn)
+	{
+		Task *task = new Task{function<void()>(forward<F>(fn)), &join};
+		join.pending.fetch_add(1, memory_order_relaxed);
+		if (currentPool == this)
+			workers[currentIndex]->tasks.push(task);
+		else
+		{
+			lock_guard<mutex> lock(injectLock);
+			injected.push_back(task);
+		}
+	}
+
+	//Waits for every task spawned on join. Instead of blocking, the caller
+	//keeps running tasks (its own first), so a worker waiting on children
+	//usually ends up running them itself.
+	void sync(Join &join)
+	{
+		int self = currentPool == this ? currentIndex : -1;
+		while (join.pending.load(memory_order_acquire) > 0)
+		{
+			Task *task;
+			if (findTask(self, task))
+				execute(task);
+			else
+				this_thread::yield();
+		}
+	}
+
+	//Runs fn on the pool and waits for it.
+	template <typename F>
+	void run(F &&fn)
+	{
+		Join join;
+		spawn(join, forward<F>(fn));
+		sync(join);
+	}
+
+	int size()
+	{
+		return (int)workers.size();
+	}
+
+	long totalSteals()
+	{
+		long sum = 0;
+		for (unique_ptr<Worker> &w : workers)
+			sum += w->steals.load(memory_order_relaxed);
+		return sum;
+	}
+};
+
+thread_local WorkStealingPool *WorkStealingPool::currentPool = nullptr;
+thread_local int WorkStealingPool::currentIndex = -1;
+
+long fib(WorkStealingPool &pool, int n)
+{
+	if (n < 20)
+	{
+		long a = 0, b = 1;
+		for (int i = 0; i < n; i++)
+		{
+			long c = a + b;
+			a = b;
+			b = c;
+		}
+		//a small fixed amount of work per leaf, like a real base case
+		volatile long burn = 0;
+		for (int i = 0; i < 20000; i++)
+			burn += i;
+		return a;
+	}
+	long x, y;
+	WorkStealingPool::Join join;
+	pool.spawn(join, [&]() { x = fib(pool, n - 1); });
+	y = fib(pool, n - 2);
+	pool.sync(join);
+	return x + y;
+}
+
+//Parallel quicksort: one half is spawned, the other recursed into directly.
+void quicksort(WorkStealingPool &pool, int *a, int n)
+{
+	if (n < 2048)
+	{
+		sort(a, a + n);
+		return;
+	}
+	int pivot = a[n / 2];
+	int *mid1 = partition(a, a + n, [pivot](int v) { return v < pivot; });
+	int *mid2 = partition(mid1, a + n, [pivot](int v) { return v == pivot; });
+	WorkStealingPool::Join join;
+	pool.spawn(join, [&pool, a, mid1]() { quicksort(pool, a, (int)(mid1 - a)); });
+	quicksort(pool, mid2, (int)(a + n - mid2));
+	pool.sync(join);
+}
+
+int main()
+{
+	//Deque on its own: the owner pushes and takes while thieves steal,
+	//every item must come out exactly once.
+	{
+		const int items = 200000;
+		ChaseLevDeque<int> dq(4);
+		vector<atomic<int>> seen(items);
+		for (atomic<int> &s : seen)
+			s.store(0);
+		atomic<bool> done(false);
+		vector<thread> thieves;
+		for (int t = 0; t < 3; t++)
+			thieves.emplace_back([&]() {
+				int v;
+				while (!done.load())
+				{
+					if (dq.steal(v))
+						seen[v]++;
+					else
+						this_thread::yield();
+				}
+			});
+		int v;
+		for (int i = 0; i < items; i++)
+		{
+			dq.push(i);
+			if (i % 3 == 0 && dq.take(v))
+				seen[v]++;
+		}
+		while (dq.size() > 0)
+			if (dq.take(v))
+				seen[v]++;
+		done.store(true);
+		for (thread &t : thieves)
+			t.join();
+		bool ok = true;
+		for (atomic<int> &s : seen)
+			ok = ok && s.load() == 1;
+		cout << "Chase-Lev deque: " << (ok ? "every item taken exactly once" : "LOST OR DUPLICATED ITEMS") << endl;
+	}
+
+	cout << "hardware threads: " << thread::hardware_concurrency() << endl;
+	int maxThreads = max(1u, thread::hardware_concurrency());
+	for (int threads = 1; threads <= maxThreads; threads *= 2)
+	{
+		WorkStealingPool pool(threads);
+
+		long result = 0;
+		auto t0 = chrono::steady_clock::now();
+		pool.run([&]() { result = fib(pool, 36); });
+		double fibMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+		vector<int> data(4000000);
+		unsigned seed = 7;
+		for (int &x : data)
+		{
+			seed = seed * 1103515245 + 12345;
+			x = (int)(seed >> 1);
+		}
+		t0 = chrono::steady_clock::now();
+		pool.run([&]() { quicksort(pool, data.data(), (int)data.size()); });
+		double sortMs = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+
+		cout << threads << " workers: fib(36) = " << result << " in " << fibMs << " ms, sort 4M in "
+			 << sortMs << " ms" << (is_sorted(data.begin(), data.end()) ? "" : " (NOT SORTED)")
+			 << ", " << pool.totalSteals() << " steals" << endl;
+	}
+	return 0;
+}
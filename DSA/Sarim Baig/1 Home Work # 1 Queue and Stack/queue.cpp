@@ -8,113 +8,144 @@
 #include <stack>
 #include <cmath>
 #include <algorithm>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
 using namespace std;
 
 template <typename T>
 class queue{//class template for circular queue
 private:
-	T * arr;//pointer to be allocated
+	T * arr;//raw storage, only slots holding elements are constructed
 	int cap;//physical size
 	int size;//logical size
-	int front, rear;
-	
+	int front;//working cell: index of the first element
+
 	int next(int i){//utility function
 		return (i+1)%cap;//cap
-	} 
+	}
+
+	//uninitialized storage, aligned for T: no default construction of
+	//empty slots, so T does not even need a default constructor
+	static T * allocate(int n){
+		return static_cast<T*>(::operator new(sizeof(T)*n,align_val_t(alignof(T))));
+	}
+
+	static void deallocate(T * p){
+		::operator delete(p,align_val_t(alignof(T)));
+	}
+
+	//moves the elements into a new array of newCap slots, front goes to 0
+	void relocate(int newCap){
+		relocateTo(allocate(newCap),newCap);
+	}
+
+	//same, into an array the caller already allocated
+	void relocateTo(T * temp,int newCap){
+		if(size>0){
+			int first=min(size,cap-front);
+			if constexpr(is_trivially_copyable<T>::value){
+				//bitwise relocation: two memcpys, no per-element work
+				memcpy(temp,arr+front,first*sizeof(T));
+				memcpy(temp+first,arr,(size-first)*sizeof(T));
+			}else{
+				for(int k=0,i=front;k<size;k++,i=next(i)){
+					new (temp+k) T(move(arr[i]));
+					arr[i].~T();
+				}
+			}
+		}
+		if(arr!=nullptr){
+			deallocate(arr);
+		}
+		arr=temp;
+		cap=newCap;
+		front=0;
+	}
+
+	void destroyAll(){
+		for(int k=0,i=front;k<size;k++,i=next(i)){
+			arr[i].~T();
+		}
+		if(arr!=nullptr){
+			deallocate(arr);
+		}
+		arr=nullptr;
+		cap=size=front=0;
+	}
 
 public:
-	//next time
-	
 	queue(int icap=0){
+		arr=nullptr;
+		cap=size=front=0;
 		if(icap>0){
-			arr=new T[icap+1];
-			cap=icap;
-		}else{//default behaviour
-			arr=nullptr;
-			cap=0;
+			relocate(icap);
 		}
-		size=0;
-		front=rear=0;//dead cell //////////////////////////We can make it working cell
 	}
 
-	void enqueue(const T& obj){
-		//is the queue full (physically)
-		if(size+1==cap){
-			//array is full, so grow it
-			T * temp = new T[cap*2];
-			//copy data from the older array
-			int k=0, i=next(front);
-			while(k<size){
-				temp[k+1]=arr[i];
-				i=next(i);
-				k++;
+	//constructs the new element directly in its slot
+	template <typename... Args>
+	T & emplace(Args&&... args){
+		if(size==cap){
+			//array is full, so grow it; the new element is built first,
+			//because args may refer to an element of the old array
+			int newCap=cap>0 ? cap*2 : 2;
+			T * temp=allocate(newCap);
+			try{
+				new (temp+size) T(forward<Args>(args)...);
+			}catch(...){
+				deallocate(temp);
+				throw;
 			}
-			//how to change front and rear values?
-			front=0;//dead cell
-			rear=size;//rear is pointing at the last element
-			rear++;
-			temp[rear]=obj;
-			cap*=2;
-			size++;
-			delete [] arr;
-			arr=temp;
-		}else if(cap==0){
-			//what should we do?
-			arr=new T[2];
-			front=0;
-			rear=1;
-			arr[1]=obj;
-			size=1;
-			cap=2;
-		}
-		else{
-			//there is a slot available
-			rear=next(rear);
-			arr[rear]=obj;
+			relocateTo(temp,newCap);
 			size++;
+			return arr[size-1];
 		}
+		T * slot=arr+(front+size)%cap;
+		new (slot) T(forward<Args>(args)...);
+		size++;
+		return *slot;
+	}
+
+	void enqueue(const T& obj){
+		emplace(obj);
+	}
+
+	void enqueue(T&& obj){
+		emplace(move(obj));
 	}
 
 	void dequeue(){
 		if(empty())
 			return;
-		
-		if((size+1)==cap/2)
-		{
-			 //array is half empty, so shrink it
-			T * temp = new T[cap/2];
-			//copy data from the older array
-			int k=0, i=next(front);
-			while(k<size){
-				temp[k+1]=arr[i];
-				i=next(i);
-				k++;
-			}
-			//how to change front and rear values?
-			front=0;//dead cell
-			rear=size;
-			
-			cap/=2;
-			front=next(front);
-			size--;
-			delete [] arr;
-			arr=temp;
-		}else{
-			front=next(front);
-			size--;
+
+		arr[front].~T();
+		front=next(front);
+		size--;
+		if(size>0 && size==cap/4){
+			//array is a quarter full, so shrink it by half
+			relocate(cap/2);
 		}
 	}
 
+	//moves the front element out and dequeues it (works for move-only T)
+	T take(){
+		T obj(move(arr[front]));
+		dequeue();
+		return obj;
+	}
 
 	void printQueue(){
 		//testing purposes
-		for(int i=front+1;i<=rear;i++){
+		for(int k=0,i=front;k<size;k++,i=next(i)){
 			cout<<arr[i]<<" ";
 		}
 	}
 	
 	const T & peek(){//read only reference
-		return arr[next(front)];
+		return arr[front];
 	}
 
 
@@ -127,48 +158,41 @@ public:
 	}
 	//destructor
 	~queue(){
-		delete [] arr;
+		destroyAll();
 	}
 
-	//add the follwing methods
 	//Copy Constructor
-	
 	queue(const queue & obj){
-		if(this==&obj){
-			return;
+		arr=nullptr;
+		cap=size=front=0;
+		if(obj.cap>0){
+			arr=allocate(obj.cap);
+			cap=obj.cap;
 		}
-		cap=obj.cap;
-		arr=new T[cap];
-		front=obj.front;
-		rear=obj.rear;
-		size=obj.size;
-		int i=next(front);
-		while(i<=rear){
-			arr[i]=obj.arr[i];
-			i=next(i);
+		for(int k=0,i=obj.front;k<obj.size;k++,i=(i+1)%obj.cap){
+			new (arr+k) T(obj.arr[i]);
+			size++;
 		}
-		
-		return *this;
 	}
-	//Assignment operator
-	
-	void operator=(const queue& obj) 
-    { 
-        if(this==&obj){
-			return;
-		} 
+
+	//Move Constructor: steals the array, nothing is copied
+	queue(queue && obj){
+		arr=obj.arr;
 		cap=obj.cap;
-		arr=new T[cap];
-		front=obj.front;
-		rear=obj.rear;
 		size=obj.size;
-		int i=next(front);
-		while(i<=rear){
-			arr[i]=obj.arr[i];
-			i=next(i);
-		}
+		front=obj.front;
+		obj.arr=nullptr;
+		obj.cap=obj.size=obj.front=0;
+	}
+
+	//Assignment operator (copy or move, by copy-and-swap)
+	queue & operator=(queue obj){
+		swap(arr,obj.arr);
+		swap(cap,obj.cap);
+		swap(size,obj.size);
+		swap(front,obj.front);
 		return *this;
-    } 
+	}
 
 };
 
@@ -183,6 +207,23 @@ int main(){
 	queue<int> q2;
 	q2=q1;
 	q2.printQueue();
+	cout<<endl;
+
+	//big payloads are moved in and relocated by move, never copied
+	queue<string> q3;
+	string big(1000000,'x');
+	q3.enqueue(move(big));
+	q3.emplace(500000,'y');
+	for(int i=0;i<10;i++)
+		q3.emplace("filler");
+	cout<<"front payload size: "<<q3.peek().size()<<endl;
+
+	//move-only elements
+	queue<unique_ptr<int>> q4;
+	q4.emplace(new int(7));
+	q4.enqueue(make_unique<int>(8));
+	unique_ptr<int> p=q4.take();
+	cout<<"took "<<*p<<", next is "<<*q4.peek()<<endl;
 	
 }
 
@@ -0,0 +1,191 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <memory>
+#include "maxHeap.h"
+
+// Relaxed concurrent priority queue ("MultiQueue"). Instead of one heap
+// behind one mutex, it keeps c * P independent MaxHeap shards, each with
+// its own lock. push() goes to a random shard; pop() looks at two random
+// shards and takes the better of their tops. Threads rarely meet on the
+// same lock, so throughput scales with cores, and the two-choice pop keeps
+// the returned element close to the true maximum (expected rank error is
+// O(number of shards)). try_lock is used everywhere: a busy shard is simply
+// skipped in favour of another random one.
+template <typename T, typename Compare = std::less<T>>
+class ConcurrentMultiQueue {
+private:
+    struct alignas(64) Shard {
+        std::mutex lock;
+        MaxHeap<T, Compare, 4> heap;
+    };
+
+    std::unique_ptr<Shard[]> shards;
+    size_t count;
+    std::atomic<long> total;
+    Compare comp;
+
+    static std::mt19937& rng() {
+        thread_local std::mt19937 gen(std::random_device{}());
+        return gen;
+    }
+
+    size_t randomShard() {
+        return rng()() % count;
+    }
+
+public:
+    ConcurrentMultiQueue(size_t threads = std::thread::hardware_concurrency(), size_t c = 2)
+        : count((threads ? threads : 1) * (c ? c : 1)), total(0) {
+        shards.reset(new Shard[count]);
+    }
+
+    void push(const T& value) {
+        while (true) {
+            Shard& s = shards[randomShard()];
+            if (s.lock.try_lock()) {
+                s.heap.insert(value);
+                total.fetch_add(1, std::memory_order_relaxed);
+                s.lock.unlock();
+                return;
+            }
+        }
+    }
+
+    // Returns false only when the whole queue was empty at some point
+    // during the call.
+    bool tryPop(T& out) {
+        while (total.load(std::memory_order_relaxed) > 0) {
+            for (int attempt = 0; attempt < 64; attempt++) {
+                size_t i = randomShard();
+                size_t j = randomShard();
+                if (i == j) {
+                    j = (j + 1) % count;
+                }
+
+                Shard& a = shards[i];
+                if (!a.lock.try_lock()) {
+                    continue;
+                }
+                Shard& b = shards[j];
+                if (count > 1 && !b.lock.try_lock()) {
+                    a.lock.unlock();
+                    continue;
+                }
+
+                Shard* best = nullptr;
+                if (!a.heap.isEmpty()) {
+                    best = &a;
+                }
+                if (count > 1 && !b.heap.isEmpty() &&
+                    (best == nullptr || comp(best->heap.getMax(), b.heap.getMax()))) {
+                    best = &b;
+                }
+                if (best != nullptr) {
+                    out = best->heap.extractMax();
+                    total.fetch_sub(1, std::memory_order_relaxed);
+                }
+
+                if (count > 1) {
+                    b.lock.unlock();
+                }
+                a.lock.unlock();
+
+                if (best != nullptr) {
+                    return true;
+                }
+            }
+
+            // Random probes keep hitting empty shards: the few remaining
+            // elements are somewhere else, so sweep every shard once.
+            for (size_t i = 0; i < count; i++) {
+                std::lock_guard<std::mutex> guard(shards[i].lock);
+                if (!shards[i].heap.isEmpty()) {
+                    out = shards[i].heap.extractMax();
+                    total.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    long size() const {
+        return total.load(std::memory_order_relaxed);
+    }
+
+    size_t shardCount() const {
+        return count;
+    }
+};
+
+int main() {
+    const int threads = 4;
+    const int perThread = 200000;
+
+    ConcurrentMultiQueue<int> pq(threads);
+    std::atomic<long long> poppedSum(0);
+    std::atomic<int> popped(0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            long long sum = 0;
+            int n = 0;
+            for (int i = 0; i < perThread; i++) {
+                pq.push(t * perThread + i);
+                int v;
+                if (i % 2 == 1 && pq.tryPop(v)) {
+                    sum += v;
+                    n++;
+                }
+            }
+            int v;
+            while (pq.tryPop(v)) {
+                sum += v;
+                n++;
+            }
+            poppedSum += sum;
+            popped += n;
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+
+    long long n = (long long)threads * perThread;
+    std::cout << "Shards: " << pq.shardCount() << std::endl;
+    std::cout << "Popped " << popped << " of " << n << " elements in " << ms << " ms" << std::endl;
+    std::cout << "Checksum " << (poppedSum == n * (n - 1) / 2 ? "ok" : "MISMATCH") << std::endl;
+
+    // Quality check: rank error = how many larger elements were still
+    // queued when an element was popped (0 for an exact priority queue).
+    const int m = 100000;
+    ConcurrentMultiQueue<int> q(threads);
+    for (int i = 0; i < m; i++) {
+        q.push(i);
+    }
+    std::vector<bool> gone(m, false);
+    long long rankError = 0;
+    int v;
+    for (int i = 0; i < 1000 && q.tryPop(v); i++) {
+        for (int j = m - 1; j > v; j--) {
+            if (!gone[j]) {
+                rankError++;
+            }
+        }
+        gone[v] = true;
+    }
+    std::cout << "Average rank error over 1000 pops: " << rankError / 1000.0 << std::endl;
+
+    return 0;
+}
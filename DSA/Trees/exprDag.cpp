@@ -0,0 +1,221 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stack>
+#include <unordered_map>
+#include <stdexcept>
+
+using namespace std;
+
+// Same node as bt.cpp. A leaf holds an operand value in data,
+// an inner node holds the operator character in data.
+struct node {
+    int data;
+    struct node* left;
+    struct node* right;
+};
+
+struct node* newNode(int data) {
+    struct node* node = new struct node;
+
+    node->data = data;
+    node->left = NULL;
+    node->right = NULL;
+
+    return node;
+}
+
+bool isLeaf(struct node* n) {
+    return n->left == NULL && n->right == NULL;
+}
+
+// Builds expression DAGs from postfix strings (same input as
+// evaluatePostfix in 134_postfixEx.cpp). Every (operator, left, right)
+// triple and every operand is created only once, so a subexpression that
+// repeats - inside one expression or across several - becomes one node.
+class ExprDag {
+private:
+    struct Key {
+        int data;
+        struct node* left;
+        struct node* right;
+
+        bool operator==(const Key& o) const {
+            return data == o.data && left == o.left && right == o.right;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            size_t h = hash<int>()(k.data);
+            h ^= hash<void*>()(k.left) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= hash<void*>()(k.right) + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    unordered_map<Key, struct node*, KeyHash> table;
+    unordered_map<struct node*, int> id;   // node -> slot in nodes
+    vector<struct node*> nodes;            // children always come before parents
+
+    struct node* intern(int data, struct node* l, struct node* r) {
+        Key k = {data, l, r};
+        auto it = table.find(k);
+        if (it != table.end())
+            return it->second;
+
+        struct node* n = newNode(data);
+        n->left = l;
+        n->right = r;
+        table[k] = n;
+        id[n] = nodes.size();
+        nodes.push_back(n);
+        return n;
+    }
+
+public:
+    ExprDag() {}
+
+    // The DAG owns its nodes.
+    ExprDag(const ExprDag&) = delete;
+    ExprDag& operator=(const ExprDag&) = delete;
+
+    // Parses one postfix expression and returns its root.
+    struct node* build(const string& exp) {
+        stack<struct node*> st;
+
+        for (char c : exp) {
+            if (isspace((unsigned char)c))
+                continue;
+
+            if (isdigit((unsigned char)c)) {
+                st.push(intern(c - '0', NULL, NULL));
+            } else {
+                if (c != '+' && c != '-' && c != '*' && c != '/')
+                    throw invalid_argument(string("Unknown operator '") + c + "'");
+                if (st.size() < 2)
+                    throw invalid_argument("Malformed postfix expression");
+                struct node* r = st.top();
+                st.pop();
+                struct node* l = st.top();
+                st.pop();
+                st.push(intern(c, l, r));
+            }
+        }
+
+        if (st.size() != 1)
+            throw invalid_argument("Malformed postfix expression");
+        return st.top();
+    }
+
+    int size() {
+        return nodes.size();
+    }
+
+    ~ExprDag() {
+        for (struct node* n : nodes)
+            delete n;
+    }
+
+    friend class DagProgram;
+};
+
+// Compact evaluator: the DAG flattened into an array of instructions
+// that refer to their operands by index. One linear pass computes every
+// shared node exactly once, with no recursion and no pointer chasing.
+class DagProgram {
+private:
+    struct Instr {
+        char op;      // 0 for a constant
+        int a, b;     // operand slots, or the constant in a
+    };
+
+    vector<Instr> code;
+    vector<int> values;
+    vector<const char*> errors;   // why a node has no value, or NULL
+
+public:
+    DagProgram(ExprDag& dag) {
+        code.reserve(dag.nodes.size());
+        for (struct node* n : dag.nodes) {
+            if (isLeaf(n))
+                code.push_back({0, n->data, 0});
+            else
+                code.push_back({(char)n->data, dag.id[n->left], dag.id[n->right]});
+        }
+        values.resize(code.size());
+        errors.resize(code.size());
+    }
+
+    // Evaluates all nodes; afterwards value() can be read for any root.
+    // A node that cannot be evaluated (division by zero, or an operand
+    // that failed) is marked instead of stopping the pass, so roots that
+    // do not depend on it still get their values.
+    void run() {
+        for (size_t i = 0; i < code.size(); i++) {
+            const Instr& in = code[i];
+            errors[i] = NULL;
+            if (in.op != 0 && (errors[in.a] != NULL || errors[in.b] != NULL)) {
+                errors[i] = errors[in.a] != NULL ? errors[in.a] : errors[in.b];
+                continue;
+            }
+            switch (in.op) {
+            case 0:
+                values[i] = in.a;
+                break;
+            case '+':
+                values[i] = values[in.a] + values[in.b];
+                break;
+            case '-':
+                values[i] = values[in.a] - values[in.b];
+                break;
+            case '*':
+                values[i] = values[in.a] * values[in.b];
+                break;
+            case '/':
+                if (values[in.b] == 0)
+                    errors[i] = "Division by zero";
+                else
+                    values[i] = values[in.a] / values[in.b];
+                break;
+            default:
+                throw invalid_argument("Unknown operator");
+            }
+        }
+    }
+
+    // Throws if root is not from this program's DAG or its value failed.
+    int value(const ExprDag& dag, struct node* root) {
+        auto it = dag.id.find(root);
+        if (it == dag.id.end() || it->second >= (int)code.size())
+            throw invalid_argument("Node is not part of this program");
+        if (errors[it->second] != NULL)
+            throw runtime_error(errors[it->second]);
+        return values[it->second];
+    }
+};
+
+int main() {
+    ExprDag dag;
+
+    // "23+" appears four times but is stored once.
+    struct node* r1 = dag.build("23+23+*");
+    struct node* r2 = dag.build("23+23+*9-");
+    struct node* r3 = dag.build("231*+9-");
+    struct node* r4 = dag.build("923+23+-/");   // 9 / (5 - 5)
+
+    DagProgram prog(dag);
+    prog.run();
+
+    cout << "DAG nodes: " << dag.size() << endl;
+    cout << "23+23+*   = " << prog.value(dag, r1) << endl;
+    cout << "23+23+*9- = " << prog.value(dag, r2) << endl;
+    cout << "231*+9-   = " << prog.value(dag, r3) << endl;
+    try {
+        prog.value(dag, r4);
+    } catch (const runtime_error& e) {
+        cout << "923+23+-/ : " << e.what() << endl;
+    }
+
+    return 0;
+}
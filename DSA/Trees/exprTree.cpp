@@ -0,0 +1,180 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <stack>
+#include <unordered_map>
+#include <stdexcept>
+
+using namespace std;
+
+// Expression tree node. Leaves are constants or variables, inner nodes
+// are operators. Every node caches its last computed value; dirty means
+// the cache is stale because something below it changed.
+struct ENode {
+    char op;          // operator, 'v' for a variable, 'c' for a constant
+    int value;
+    bool dirty;
+    ENode* left;
+    ENode* right;
+    ENode* parent;
+};
+
+ENode* createENode(char op, int value) {
+    ENode* n = new ENode();
+    n->op = op;
+    n->value = value;
+    n->dirty = true;
+    n->left = nullptr;
+    n->right = nullptr;
+    n->parent = nullptr;
+    return n;
+}
+
+// Builds a tree from postfix (digits, single-letter variables, + - * /)
+// and keeps it evaluated. set() only dirties the path from each changed
+// leaf to the root, so the next value() costs O(depth) instead of O(n).
+class ExprTree {
+private:
+    ENode* root;
+    unordered_map<char, vector<ENode*>> vars;  // a variable may occur many times
+    int recomputed;                            // nodes recomputed by the last value()
+
+    int apply(char op, int a, int b) {
+        switch (op) {
+        case '+':
+            return a + b;
+        case '-':
+            return a - b;
+        case '*':
+            return a * b;
+        case '/':
+            if (b == 0)
+                throw runtime_error("Division by zero");
+            return a / b;
+        }
+        throw invalid_argument("Unknown operator");
+    }
+
+    // Recomputes only the stale part of the tree. Clean subtrees are
+    // answered from their cache without being visited.
+    int refresh(ENode* n) {
+        if (!n->dirty)
+            return n->value;
+        if (n->op != 'v' && n->op != 'c')
+            n->value = apply(n->op, refresh(n->left), refresh(n->right));
+        n->dirty = false;
+        recomputed++;
+        return n->value;
+    }
+
+    void destroy(ENode* n) {
+        if (n == nullptr)
+            return;
+        destroy(n->left);
+        destroy(n->right);
+        delete n;
+    }
+
+public:
+    ExprTree(const string& exp) {
+        stack<ENode*> st;
+        recomputed = 0;
+
+        // Every node built so far is on the stack or below a node that is,
+        // so on malformed input freeing the stack frees them all.
+        try {
+            for (char c : exp) {
+                if (isspace((unsigned char)c))
+                    continue;
+
+                if (isdigit((unsigned char)c)) {
+                    st.push(createENode('c', c - '0'));
+                } else if (isalpha((unsigned char)c)) {
+                    ENode* leaf = createENode('v', 0);
+                    st.push(leaf);
+                    vars[c].push_back(leaf);
+                } else {
+                    if (c != '+' && c != '-' && c != '*' && c != '/')
+                        throw invalid_argument(string("Unknown operator '") + c + "'");
+                    if (st.size() < 2)
+                        throw invalid_argument("Malformed postfix expression");
+                    ENode* n = createENode(c, 0);
+                    ENode* r = st.top();
+                    st.pop();
+                    ENode* l = st.top();
+                    st.pop();
+                    n->left = l;
+                    n->right = r;
+                    l->parent = n;
+                    r->parent = n;
+                    st.push(n);
+                }
+            }
+
+            if (st.size() != 1)
+                throw invalid_argument("Malformed postfix expression");
+        } catch (...) {
+            while (!st.empty()) {
+                destroy(st.top());
+                st.pop();
+            }
+            throw;
+        }
+        root = st.top();
+    }
+
+    // The tree owns its nodes.
+    ExprTree(const ExprTree&) = delete;
+    ExprTree& operator=(const ExprTree&) = delete;
+
+    ~ExprTree() {
+        destroy(root);
+    }
+
+    // Changes an input. Propagation stops at the first node that is
+    // already dirty, since everything above it is dirty as well.
+    void set(char var, int value) {
+        auto it = vars.find(var);
+        if (it == vars.end())
+            throw invalid_argument("Unknown variable");
+
+        for (ENode* leaf : it->second) {
+            if (leaf->value == value && !leaf->dirty)
+                continue;
+            leaf->value = value;
+            for (ENode* n = leaf; n != nullptr && !n->dirty; n = n->parent)
+                n->dirty = true;
+        }
+    }
+
+    int value() {
+        recomputed = 0;
+        return refresh(root);
+    }
+
+    int lastRecomputed() {
+        return recomputed;
+    }
+};
+
+int main() {
+    // (a + b) * (c - 4) + (d * 2) / (e + 1)
+    ExprTree t("ab+c4-*d2*e1+/+");
+    t.set('a', 2);
+    t.set('b', 3);
+    t.set('c', 9);
+    t.set('d', 7);
+    t.set('e', 1);
+
+    cout << "Initial value: " << t.value()
+         << " (" << t.lastRecomputed() << " nodes computed)" << endl;
+
+    t.set('d', 10);
+    cout << "After d = 10:  " << t.value()
+         << " (" << t.lastRecomputed() << " nodes computed)" << endl;
+
+    cout << "Unchanged:     " << t.value()
+         << " (" << t.lastRecomputed() << " nodes computed)" << endl;
+
+    return 0;
+}
@@ -0,0 +1,314 @@
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include "maxHeap.h"
+
+// Byte-oriented Huffman codec.
+//  - The tree is built with MaxHeap in min mode (std::greater) on
+//    (frequency, node) pairs; only the resulting code lengths are kept.
+//  - Codes are canonical, so the lengths alone (256 bytes) describe them.
+//    Lengths are capped at MaxLen by flattening the frequencies and
+//    rebuilding, which only happens for extremely skewed inputs.
+//  - The bit stream is LSB-first. The encoder keeps a 64-bit accumulator
+//    and stores 8 bytes after every symbol, advancing by the whole bytes
+//    filled: no per-bit or per-byte branches.
+//  - The decoder indexes a 2^TableBits table with the next bits of the
+//    stream; each entry yields up to 3 whole symbols at once. Codes longer
+//    than TableBits fall back to a canonical bit-by-bit decode.
+class HuffmanCodec {
+public:
+    static const int MaxLen = 15;
+    static const int TableBits = 11;
+
+private:
+    struct Entry {
+        uint8_t sym[3];
+        uint8_t count;   // symbols in this entry, 0 = needs the slow path
+        uint8_t bits;    // bits consumed by those symbols
+    };
+
+    uint8_t length[256];
+    uint16_t reversed[256];          // code bit-reversed for LSB-first output
+    uint16_t firstCode[MaxLen + 2];  // canonical decode tables
+    uint16_t countOf[MaxLen + 2];
+    uint16_t offsetOf[MaxLen + 2];
+    uint8_t sorted[256];
+    std::vector<Entry> table;
+
+    static void buildLengths(const uint64_t freq[256], uint8_t out[256]) {
+        std::vector<uint64_t> f(freq, freq + 256);
+        while (true) {
+            std::vector<int> parent(512, -1);
+            MaxHeap<std::pair<uint64_t, int>, std::greater<std::pair<uint64_t, int>>> heap;
+            int used = 0;
+            for (int s = 0; s < 256; s++) {
+                if (f[s] > 0) {
+                    heap.insert({f[s], s});
+                    used++;
+                }
+            }
+
+            std::fill(out, out + 256, 0);
+            if (used == 0) {
+                return;
+            }
+            if (used == 1) {
+                out[heap.getMax().second] = 1;
+                return;
+            }
+
+            int next = 256;
+            while (heap.size() > 1) {
+                std::pair<uint64_t, int> a = heap.extractMax();
+                std::pair<uint64_t, int> b = heap.extractMax();
+                parent[a.second] = parent[b.second] = next;
+                heap.insert({a.first + b.first, next});
+                next++;
+            }
+
+            int longest = 0;
+            for (int s = 0; s < 256; s++) {
+                if (f[s] > 0) {
+                    int depth = 0;
+                    for (int n = s; parent[n] != -1; n = parent[n]) {
+                        depth++;
+                    }
+                    out[s] = depth;
+                    longest = std::max(longest, depth);
+                }
+            }
+            if (longest <= MaxLen) {
+                return;
+            }
+            for (uint64_t& x : f) {
+                if (x > 0) {
+                    x = (x >> 1) | 1;
+                }
+            }
+        }
+    }
+
+    void buildCodes() {
+        std::fill(countOf, countOf + MaxLen + 2, 0);
+        for (int s = 0; s < 256; s++) {
+            if (length[s] > MaxLen) {
+                throw std::invalid_argument("Code length too long");
+            }
+            countOf[length[s]]++;
+        }
+        countOf[0] = 0;
+
+        // Canonical assignment: shorter codes first, then by symbol.
+        uint16_t code = 0;
+        uint16_t offset = 0;
+        for (int len = 1; len <= MaxLen; len++) {
+            firstCode[len] = code;
+            offsetOf[len] = offset;
+            offset += countOf[len];
+            code = (code + countOf[len]) << 1;
+        }
+
+        uint16_t next[MaxLen + 2];
+        std::copy(firstCode, firstCode + MaxLen + 2, next);
+        int k = 0;
+        for (int len = 1; len <= MaxLen; len++) {
+            for (int s = 0; s < 256; s++) {
+                if (length[s] == len) {
+                    sorted[k++] = s;
+                    uint16_t c = next[len]++;
+                    uint16_t r = 0;
+                    for (int i = 0; i < len; i++) {
+                        r = (r << 1) | ((c >> i) & 1);
+                    }
+                    reversed[s] = r;
+                }
+            }
+        }
+
+        // Single-symbol table first, then combine into multi-symbol entries.
+        const uint32_t size = 1u << TableBits;
+        std::vector<std::pair<int, int>> single(size, std::make_pair(-1, 0));
+        for (int s = 0; s < 256; s++) {
+            int len = length[s];
+            if (len == 0 || len > TableBits) {
+                continue;
+            }
+            for (uint32_t high = 0; high < (size >> len); high++) {
+                single[reversed[s] | (high << len)] = std::make_pair(s, len);
+            }
+        }
+
+        table.assign(size, Entry());
+        for (uint32_t p = 0; p < size; p++) {
+            Entry& e = table[p];
+            e.count = 0;
+            e.bits = 0;
+            while (e.count < 3) {
+                std::pair<int, int> d = single[(p >> e.bits) & (size - 1)];
+                if (d.first < 0 || e.bits + d.second > TableBits) {
+                    break;
+                }
+                e.sym[e.count++] = d.first;
+                e.bits += d.second;
+            }
+        }
+    }
+
+    // Canonical decode of one symbol, reading bits one at a time.
+    int slowDecode(const uint8_t* in, size_t size, uint64_t& pos) const {
+        uint32_t code = 0;
+        for (int len = 1; len <= MaxLen; len++) {
+            size_t byte = pos >> 3;
+            if (byte >= size) {
+                break;
+            }
+            code = (code << 1) | ((in[byte] >> (pos & 7)) & 1);
+            pos++;
+            if (code - firstCode[len] < countOf[len]) {
+                return sorted[offsetOf[len] + code - firstCode[len]];
+            }
+        }
+        throw std::runtime_error("Corrupt Huffman stream");
+    }
+
+    static uint64_t peek(const uint8_t* in, size_t size, size_t byte) {
+        uint64_t w = 0;
+        if (byte + 8 <= size) {
+            std::memcpy(&w, in + byte, 8);   // little-endian host assumed
+        } else {
+            for (size_t i = 0; byte + i < size; i++) {
+                w |= (uint64_t)in[byte + i] << (8 * i);
+            }
+        }
+        return w;
+    }
+
+public:
+    // Builds the code from the symbol frequencies of a sample.
+    HuffmanCodec(const std::vector<uint8_t>& sample) {
+        uint64_t freq[256] = {0};
+        for (uint8_t b : sample) {
+            freq[b]++;
+        }
+        buildLengths(freq, length);
+        buildCodes();
+    }
+
+    // Rebuilds the same code on the decoding side from the lengths alone.
+    HuffmanCodec(const uint8_t lengths[256]) {
+        std::copy(lengths, lengths + 256, length);
+        buildCodes();
+    }
+
+    const uint8_t* lengths() const {
+        return length;
+    }
+
+    std::vector<uint8_t> encode(const std::vector<uint8_t>& data) const {
+        for (uint8_t b : data) {
+            if (length[b] == 0) {
+                throw std::invalid_argument("Symbol has no code");
+            }
+        }
+
+        // Worst case plus room for the final 8-byte store.
+        std::vector<uint8_t> out((data.size() * MaxLen + 7) / 8 + 8);
+        uint8_t* p = out.data();
+        uint64_t acc = 0;
+        unsigned bits = 0;
+        for (uint8_t b : data) {
+            acc |= (uint64_t)reversed[b] << bits;
+            bits += length[b];
+            std::memcpy(p, &acc, 8);
+            p += bits >> 3;
+            acc >>= bits & ~7u;
+            bits &= 7;
+        }
+        std::memcpy(p, &acc, 8);
+        p += (bits + 7) >> 3;
+
+        out.resize(p - out.data());
+        return out;
+    }
+
+    std::vector<uint8_t> decode(const std::vector<uint8_t>& in, size_t count) const {
+        std::vector<uint8_t> out(count);
+        const uint8_t* src = in.data();
+        size_t size = in.size();
+        uint64_t pos = 0;
+        size_t n = 0;
+        const uint32_t mask = (1u << TableBits) - 1;
+
+        // Fast loop: a full 8-byte read is always possible and there is
+        // room for 3 symbols, so every entry's symbols are stored blindly.
+        while (n + 3 <= count && (pos >> 3) + 8 <= size) {
+            uint64_t w;
+            std::memcpy(&w, src + (pos >> 3), 8);
+            w >>= pos & 7;
+            const Entry& e = table[w & mask];
+            if (e.count == 0) {
+                out[n++] = slowDecode(src, size, pos);
+                continue;
+            }
+            out[n] = e.sym[0];
+            out[n + 1] = e.sym[1];
+            out[n + 2] = e.sym[2];
+            n += e.count;
+            pos += e.bits;
+        }
+
+        while (n < count) {
+            uint64_t w = peek(src, size, pos >> 3) >> (pos & 7);
+            const Entry& e = table[w & mask];
+            if (e.count > 0 && n + e.count <= count) {
+                out[n] = e.sym[0];
+                if (e.count > 1) out[n + 1] = e.sym[1];
+                if (e.count > 2) out[n + 2] = e.sym[2];
+                n += e.count;
+                pos += e.bits;
+            } else {
+                out[n++] = slowDecode(src, size, pos);
+            }
+        }
+        return out;
+    }
+};
+
+int main() {
+    // Heavily skewed bytes: geometric distribution over the alphabet.
+    const size_t n = 50 * 1000 * 1000;
+    std::mt19937 gen(11);
+    std::geometric_distribution<int> skew(0.25);
+    std::vector<uint8_t> data(n);
+    for (uint8_t& b : data) {
+        b = (uint8_t)std::min(skew(gen), 255);
+    }
+
+    HuffmanCodec encoder(data);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<uint8_t> packed = encoder.encode(data);
+    auto t1 = std::chrono::steady_clock::now();
+
+    HuffmanCodec decoder(encoder.lengths());
+    std::vector<uint8_t> unpacked = decoder.decode(packed, data.size());
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto mbps = [n](std::chrono::steady_clock::duration d) {
+        return n / 1e6 / std::chrono::duration<double>(d).count();
+    };
+    std::cout << "Compressed " << n << " bytes to " << packed.size()
+              << " (" << 100.0 * packed.size() / n << "%)" << std::endl;
+    std::cout << "Encode: " << (int)mbps(t1 - t0) << " MB/s, decode: "
+              << (int)mbps(t2 - t1) << " MB/s" << std::endl;
+    std::cout << (unpacked == data ? "Round trip ok" : "MISMATCH") << std::endl;
+
+    return 0;
+}
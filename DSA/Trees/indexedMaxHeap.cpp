@@ -0,0 +1,36 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include "indexedMaxHeap.h"
+
+int main() {
+    // A tiny scheduler: task names live outside the heap, indexed by handle.
+    IndexedMaxHeap<int> pq;
+    std::vector<std::string> names;
+
+    auto add = [&](const std::string& name, int priority) {
+        IndexedMaxHeap<int>::Handle h = pq.push(priority);
+        if (h >= names.size()) {
+            names.resize(h + 1);
+        }
+        names[h] = name;
+        return h;
+    };
+
+    IndexedMaxHeap<int>::Handle backup = add("backup", 3);
+    IndexedMaxHeap<int>::Handle email = add("email", 5);
+    IndexedMaxHeap<int>::Handle build = add("build", 8);
+    add("deploy", 6);
+
+    pq.update(backup, 10);   // increase-key
+    pq.update(build, 1);     // decrease-key
+    pq.erase(email);         // cancelled, no stale copy left behind
+
+    std::cout << "Live tasks: " << pq.size() << std::endl;
+    while (!pq.isEmpty()) {
+        int p = pq.getMax();
+        std::cout << names[pq.removeMax()] << " (" << p << ") ";
+    }
+
+    return 0;
+}
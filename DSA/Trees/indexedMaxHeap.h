@@ -0,0 +1,184 @@
+#ifndef INDEXEDMAXHEAP_H
+#define INDEXEDMAXHEAP_H
+
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+// d-ary heap of priorities addressed through stable handles. push()
+// returns a handle that stays valid until that entry is popped or erased;
+// a position map (handle -> slot) lets update() and erase() find the entry
+// in O(1) and fix the heap in O(log n). The heap only ever holds live
+// entries, so there is no need for lazy deletion of stale copies.
+// Freed handles are recycled by later pushes.
+template <typename P = int, typename Compare = std::less<P>, int Arity = 2>
+class IndexedMaxHeap {
+    static_assert(Arity >= 2, "IndexedMaxHeap arity must be at least 2");
+
+public:
+    typedef size_t Handle;
+    static constexpr size_t npos = (size_t)-1;
+
+private:
+    std::vector<Handle> heap;   // slot -> handle
+    std::vector<size_t> pos;    // handle -> slot, npos when free
+    std::vector<P> prio;        // handle -> priority
+    std::vector<Handle> freeHandles;
+    Compare comp;
+
+    bool before(Handle a, Handle b) const {
+        return comp(prio[a], prio[b]);
+    }
+
+    void place(size_t slot, Handle h) {
+        heap[slot] = h;
+        pos[h] = slot;
+    }
+
+    void heapifyUp(size_t index) {
+        Handle h = heap[index];
+        while (index > 0) {
+            size_t parent = (index - 1) / Arity;
+            if (!before(heap[parent], h)) {
+                break;
+            }
+            place(index, heap[parent]);
+            index = parent;
+        }
+        place(index, h);
+    }
+
+    void heapifyDown(size_t index) {
+        Handle h = heap[index];
+        size_t n = heap.size();
+        while (true) {
+            size_t first = Arity * index + 1;
+            if (first >= n) {
+                break;
+            }
+
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t largest = first;
+            for (size_t c = first + 1; c < last; c++) {
+                if (before(heap[largest], heap[c])) {
+                    largest = c;
+                }
+            }
+
+            if (!before(h, heap[largest])) {
+                break;
+            }
+            place(index, heap[largest]);
+            index = largest;
+        }
+        place(index, h);
+    }
+
+    void checkLive(Handle h) const {
+        if (!contains(h)) {
+            throw std::out_of_range("Invalid heap handle");
+        }
+    }
+
+    // Takes the entry in the given slot out of the heap and frees its handle.
+    void removeAt(size_t slot) {
+        Handle h = heap[slot];
+        Handle moved = heap.back();
+        heap.pop_back();
+        pos[h] = npos;
+        freeHandles.push_back(h);
+
+        if (slot < heap.size()) {
+            place(slot, moved);
+            if (slot > 0 && before(heap[(slot - 1) / Arity], moved)) {
+                heapifyUp(slot);
+            } else {
+                heapifyDown(slot);
+            }
+        }
+    }
+
+public:
+    IndexedMaxHeap(const Compare& c = Compare()) : comp(c) {}
+
+    Handle push(const P& priority) {
+        Handle h;
+        if (!freeHandles.empty()) {
+            h = freeHandles.back();
+            freeHandles.pop_back();
+            prio[h] = priority;
+        } else {
+            h = prio.size();
+            prio.push_back(priority);
+            pos.push_back(npos);
+        }
+
+        heap.push_back(h);
+        pos[h] = heap.size() - 1;
+        heapifyUp(heap.size() - 1);
+        return h;
+    }
+
+    // Changes the priority of a queued entry; works both ways
+    // (increase-key sifts up, decrease-key sifts down).
+    void update(Handle h, const P& priority) {
+        checkLive(h);
+        bool up = comp(prio[h], priority);
+        prio[h] = priority;
+        if (up) {
+            heapifyUp(pos[h]);
+        } else {
+            heapifyDown(pos[h]);
+        }
+    }
+
+    void erase(Handle h) {
+        checkLive(h);
+        removeAt(pos[h]);
+    }
+
+    bool contains(Handle h) const {
+        return h < pos.size() && pos[h] != npos;
+    }
+
+    const P& priority(Handle h) const {
+        checkLive(h);
+        return prio[h];
+    }
+
+    Handle topHandle() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return heap[0];
+    }
+
+    const P& getMax() const {
+        return prio[topHandle()];
+    }
+
+    // Removes the top entry and returns its (now released) handle.
+    Handle removeMax() {
+        Handle h = topHandle();
+        removeAt(0);
+        return h;
+    }
+
+    bool isEmpty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    void clear() {
+        heap.clear();
+        pos.clear();
+        prio.clear();
+        freeHandles.clear();
+    }
+};
+
+#endif
@@ -0,0 +1,260 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <iterator>
+#include <functional>
+#include <utility>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <climits>
+#include <type_traits>
+#include "maxHeap.h"
+
+// k-way merge of sorted sources with a tournament (loser) tree. Each
+// internal node remembers the loser of the match played there and the
+// overall winner sits in tree[0]. After the winner is output only its own
+// leaf-to-root path is replayed, against the stored losers: exactly one
+// comparison per level, about log2 k per element. Each node keeps the
+// loser's key next to its source index, so a match reads only the node
+// it is played at.
+//
+// An exhausted source gets a sentinel head that sorts after every real
+// element, so a match is a single comparison with no "is it finished"
+// checks on the way up. The sentinel defaults to the largest value for
+// std::less (smallest for std::greater) on arithmetic types; other keys
+// or comparators must pass one, and no real element may compare equal to
+// or after it.
+//
+// Sources are [first, last) pairs of input iterators, so vectors, arrays
+// and std::istream_iterator over files all work.
+template <typename T, typename Compare>
+struct LastKey {
+    static T value() {
+        static_assert(std::is_arithmetic<T>::value, "pass a sentinel to LoserTreeMerger");
+        return std::numeric_limits<T>::max();
+    }
+};
+
+template <typename T>
+struct LastKey<T, std::greater<T>> {
+    static T value() {
+        static_assert(std::is_arithmetic<T>::value, "pass a sentinel to LoserTreeMerger");
+        return std::numeric_limits<T>::lowest();
+    }
+};
+
+template <typename It, typename Compare = std::less<typename std::iterator_traits<It>::value_type>>
+class LoserTreeMerger {
+public:
+    typedef typename std::iterator_traits<It>::value_type T;
+
+private:
+    // A player: a source and its current head. The internal nodes store
+    // the loser's key next to its index, so a match reads the node it is
+    // played at and nothing else.
+    struct Entry {
+        T key;                  // sentinel once the source is exhausted
+        size_t src;
+    };
+
+    std::vector<std::pair<It, It>> sources;
+    size_t live;                // sources not yet exhausted
+    std::vector<Entry> tree;    // tree[0] = winner, tree[1..k-1] = losers
+    size_t k;
+    Compare comp;
+    T sentinel;
+
+    // Next head of source i. Exhausted sources get the sentinel, which
+    // loses against every real head, so matches need no special case.
+    T advance(size_t i) {
+        if (sources[i].first == sources[i].second) {
+            live--;
+            return sentinel;
+        }
+        T key = *sources[i].first;
+        ++sources[i].first;
+        return key;
+    }
+
+    // Initial tournament: play every match bottom-up, keep the loser in
+    // the node and pass the winner on.
+    void build(std::vector<Entry>& players) {
+        if (k == 0) {
+            return;
+        }
+        std::vector<Entry> winner(2 * k);
+        for (size_t i = 0; i < k; i++) {
+            winner[k + i] = std::move(players[i]);
+        }
+        for (size_t node = k - 1; node >= 1; node--) {
+            Entry& a = winner[2 * node];
+            Entry& b = winner[2 * node + 1];
+            // On a tie the left player wins.
+            if (!comp(b.key, a.key)) {
+                winner[node] = std::move(a);
+                tree[node] = std::move(b);
+            } else {
+                winner[node] = std::move(b);
+                tree[node] = std::move(a);
+            }
+        }
+        tree[0] = std::move(winner[k == 1 ? k : 1]);
+    }
+
+    // The winner's source has a new head: replay its path to the root,
+    // one comparison per level against the stored loser.
+    void replay(Entry w) {
+        for (size_t node = (k + w.src) / 2; node >= 1; node /= 2) {
+            Entry& l = tree[node];
+            if (!comp(w.key, l.key)) {
+                std::swap(l, w);   // the stored loser wins this match (ties too)
+            }
+        }
+        tree[0] = std::move(w);
+    }
+
+public:
+    LoserTreeMerger(std::vector<std::pair<It, It>> inputs, const Compare& c = Compare(),
+                    const T& last = LastKey<T, Compare>::value())
+        : sources(std::move(inputs)), k(sources.size()), comp(c), sentinel(last) {
+        live = k;
+        tree.resize(k > 0 ? k : 1);
+        std::vector<Entry> players(k);
+        for (size_t i = 0; i < k; i++) {
+            players[i].key = advance(i);
+            players[i].src = i;
+        }
+        build(players);
+    }
+
+    bool empty() const {
+        return live == 0;
+    }
+
+    // Writes up to max merged elements to out and returns how many.
+    template <typename Out>
+    size_t nextBatch(Out out, size_t max) {
+        return produce(out, max);
+    }
+
+    // Merges everything into out.
+    template <typename Out>
+    void mergeAll(Out out) {
+        produce(out, std::numeric_limits<size_t>::max());
+    }
+
+private:
+    // out is advanced in place, so mergeAll works with plain iterators
+    // as well as inserters.
+    template <typename Out>
+    size_t produce(Out& out, size_t max) {
+        size_t produced = 0;
+        while (produced < max && !empty()) {
+            size_t w = tree[0].src;
+            *out = std::move(tree[0].key);
+            ++out;
+            produced++;
+            replay(Entry{advance(w), w});
+        }
+        return produced;
+    }
+};
+
+// Counts comparisons so both merges can be compared on work done.
+struct CountingLess {
+    long long* count;
+    bool operator()(int a, int b) const {
+        ++*count;
+        return a < b;
+    }
+};
+
+struct CountingGreater {
+    long long* count;
+    bool operator()(const std::pair<int, int>& a, const std::pair<int, int>& b) const {
+        ++*count;
+        return a > b;
+    }
+};
+
+// The MaxHeap way: (value, run) pairs in a min-mode heap, replaceMax with
+// the run's next value.
+template <typename Out, typename Compare>
+void heapMerge(const std::vector<std::vector<int>>& data, Out out, Compare comp) {
+    std::vector<size_t> at(data.size(), 0);
+    MaxHeap<std::pair<int, int>, Compare> heap(comp);
+    for (int r = 0; r < (int)data.size(); r++) {
+        if (!data[r].empty()) {
+            heap.insert({data[r][0], r});
+        }
+    }
+    while (!heap.isEmpty()) {
+        std::pair<int, int> top = heap.getMax();
+        *out = top.first;
+        ++out;
+        if (++at[top.second] < data[top.second].size()) {
+            heap.replaceMax({data[top.second][at[top.second]], top.second});
+        } else {
+            heap.removeMax();
+        }
+    }
+}
+
+int main() {
+    // Log-style runs read from streams (stand-ins for files).
+    std::istringstream f1("1 4 9 12"), f2("2 3 10"), f3("0 5 6 7 8 11");
+    typedef std::istream_iterator<int> In;
+    LoserTreeMerger<In> files({{In(f1), In()}, {In(f2), In()}, {In(f3), In()}});
+    files.mergeAll(std::ostream_iterator<int>(std::cout, " "));
+    std::cout << std::endl;
+
+    // Hundreds of sorted runs, compared against merging with MaxHeap.
+    const int runs = 500, perRun = 20000;
+    std::mt19937 gen(3);
+    std::vector<std::vector<int>> data(runs, std::vector<int>(perRun));
+    for (std::vector<int>& r : data) {
+        for (int& v : r) {
+            v = gen() % 100000000;
+        }
+        std::sort(r.begin(), r.end());
+    }
+
+    typedef std::vector<int>::const_iterator VIt;
+    std::vector<std::pair<VIt, VIt>> inputs;
+    for (const std::vector<int>& r : data) {
+        inputs.push_back({r.begin(), r.end()});
+    }
+
+    // Both outputs are allocated and touched before the clock starts.
+    const size_t total = (size_t)runs * perRun;
+    std::vector<int> merged(total), viaHeap(total);
+
+    auto t0 = std::chrono::steady_clock::now();
+    LoserTreeMerger<VIt> lt(inputs);
+    lt.mergeAll(merged.begin());
+    auto t1 = std::chrono::steady_clock::now();
+    heapMerge(data, viaHeap.begin(), std::greater<std::pair<int, int>>());
+    auto t2 = std::chrono::steady_clock::now();
+
+    // Comparisons are counted in separate runs so the counter does not
+    // slow down the timed ones.
+    long long treeCompares = 0, heapCompares = 0;
+    std::vector<int> scratch(total);
+    LoserTreeMerger<VIt, CountingLess> counted(inputs, CountingLess{&treeCompares}, INT_MAX);
+    counted.mergeAll(scratch.begin());
+    heapMerge(data, scratch.begin(), CountingGreater{&heapCompares});
+
+    auto ms = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+    std::cout << "Merged " << total << " elements from " << runs << " runs" << std::endl;
+    std::cout << "Loser tree: " << ms(t1 - t0) << " ms, "
+              << (double)treeCompares / total << " comparisons per element" << std::endl;
+    std::cout << "MaxHeap:    " << ms(t2 - t1) << " ms, "
+              << (double)heapCompares / total << " comparisons per element" << std::endl;
+    std::cout << (merged == viaHeap && std::is_sorted(merged.begin(), merged.end()) ? "Outputs match" : "MISMATCH") << std::endl;
+
+    return 0;
+}
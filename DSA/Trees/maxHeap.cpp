@@ -1,68 +1,10 @@
 #include <iostream>
+#include <string>
 #include <vector>
-
-class MaxHeap {
-private:
-    std::vector<int> heap;
-
-    void heapifyUp(int index) {
-        int parent = (index - 1) / 2;
-        if (index > 0 && heap[index] > heap[parent]) {
-            std::swap(heap[index], heap[parent]);
-            heapifyUp(parent);
-        }
-    }
-
-    void heapifyDown(int index) {
-        int left = 2 * index + 1;
-        int right = 2 * index + 2;
-        int largest = index;
-
-        if (left < heap.size() && heap[left] > heap[largest]) {
-            largest = left;
-        }
-
-        if (right < heap.size() && heap[right] > heap[largest]) {
-            largest = right;
-        }
-
-        if (largest != index) {
-            std::swap(heap[index], heap[largest]);
-            heapifyDown(largest);
-        }
-    }
-
-public:
-    void insert(int value) {
-        heap.push_back(value);
-        heapifyUp(heap.size() - 1);
-    }
-
-    void removeMax() {
-        if (heap.empty()) {
-            return;
-        }
-
-        std::swap(heap[0], heap[heap.size() - 1]);
-        heap.pop_back();
-        heapifyDown(0);
-    }
-
-    int getMax() {
-        if (heap.empty()) {
-            throw std::out_of_range("Heap is empty");
-        }
-
-        return heap[0];
-    }
-
-    bool isEmpty() {
-        return heap.empty();
-    }
-};
+#include "maxHeap.h"
 
 int main() {
-    MaxHeap maxHeap;
+    MaxHeap<int> maxHeap;
     maxHeap.insert(10);
     maxHeap.insert(5);
     maxHeap.insert(7);
@@ -73,6 +15,28 @@ int main() {
         std::cout << maxHeap.getMax() << " ";
         maxHeap.removeMax();
     }
+    std::cout << std::endl;
+
+    std::vector<int> values = {4, 19, 8, 1, 15, 23, 6, 11};
+    MaxHeap<int> built(values.begin(), values.end());
+    int more[] = {30, 2, 17};
+    built.push_bulk(more, more + 3);
+    std::cout << "Built heap max: " << built.getMax() << ", size: " << built.size() << std::endl;
+
+    MaxHeap<int>::heapsort(values);
+    for (int v : values) {
+        std::cout << v << " ";
+    }
+    std::cout << std::endl;
+
+    // 4-ary min heap of strings: elements are moved, never copied, while sifting.
+    MaxHeap<std::string, std::greater<std::string>, 4> words;
+    for (const char* w : {"pear", "apple", "fig", "kiwi", "banana", "cherry"}) {
+        words.emplace(w);
+    }
+    while (!words.isEmpty()) {
+        std::cout << words.extractMax() << " ";
+    }
 
     return 0;
 }
@@ -0,0 +1,232 @@
+#ifndef MAXHEAP_H
+#define MAXHEAP_H
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+// Array-based d-ary heap. With the default std::less the largest element
+// is on top; pass std::greater to get a min heap. Arity 4 or 8 keeps all
+// children of a node in one or two cache lines and halves/thirds the
+// height of the tree, at the cost of more comparisons per level.
+template <typename T = int, typename Compare = std::less<T>, int Arity = 2>
+class MaxHeap {
+    static_assert(Arity >= 2, "MaxHeap arity must be at least 2");
+
+private:
+    std::vector<T> heap;
+    Compare comp;
+
+    static size_t parentOf(size_t index) {
+        return (index - 1) / Arity;
+    }
+
+    static size_t firstChild(size_t index) {
+        return Arity * index + 1;
+    }
+
+    // Hole-based sift up: the moving element is held aside and each
+    // parent is moved down into the hole once, instead of a full swap
+    // per level. Iterative, so no recursion depth to worry about.
+    void heapifyUp(size_t index) {
+        T value = std::move(heap[index]);
+        while (index > 0) {
+            size_t parent = parentOf(index);
+            if (!comp(heap[parent], value)) {
+                break;
+            }
+            heap[index] = std::move(heap[parent]);
+            index = parent;
+        }
+        heap[index] = std::move(value);
+    }
+
+    void heapifyDown(size_t index) {
+        heapifyDown(index, heap.size());
+    }
+
+    // Sift down within the first n elements only (used by heapsort).
+    void heapifyDown(size_t index, size_t n) {
+        T value = std::move(heap[index]);
+        while (true) {
+            size_t first = firstChild(index);
+            if (first >= n) {
+                break;
+            }
+
+            size_t last = first + Arity < n ? first + Arity : n;
+            size_t largest = first;
+            for (size_t c = first + 1; c < last; c++) {
+                if (comp(heap[largest], heap[c])) {
+                    largest = c;
+                }
+            }
+
+            if (!comp(value, heap[largest])) {
+                break;
+            }
+            heap[index] = std::move(heap[largest]);
+            index = largest;
+        }
+        heap[index] = std::move(value);
+    }
+
+    // Floyd's bottom-up heap construction: sift down every parent,
+    // starting from the last one. O(n) instead of n inserts' O(n log n).
+    void buildHeap() {
+        if (heap.size() < 2) {
+            return;
+        }
+        for (size_t i = parentOf(heap.size() - 1) + 1; i-- > 0;) {
+            heapifyDown(i);
+        }
+    }
+
+public:
+    MaxHeap(const Compare& c = Compare()) : comp(c) {}
+
+    MaxHeap(std::vector<T> values, const Compare& c = Compare())
+        : heap(std::move(values)), comp(c) {
+        buildHeap();
+    }
+
+    template <typename It>
+    MaxHeap(It first, It last, const Compare& c = Compare())
+        : heap(first, last), comp(c) {
+        buildHeap();
+    }
+
+    // Replaces the contents with [first, last) in O(n).
+    template <typename It>
+    void assign(It first, It last) {
+        heap.assign(first, last);
+        buildHeap();
+    }
+
+    // Adds a batch. Small batches are sifted up one by one; once the
+    // batch is big enough that k log(n + k) exceeds n + k, rebuilding
+    // the whole heap bottom-up is cheaper.
+    template <typename It>
+    void push_bulk(It first, It last) {
+        size_t oldSize = heap.size();
+        heap.insert(heap.end(), first, last);
+        size_t k = heap.size() - oldSize;
+        if (k == 0) {
+            return;
+        }
+
+        size_t logN = 0;
+        for (size_t n = heap.size(); n > 1; n /= Arity) {
+            logN++;
+        }
+
+        if (k * logN > heap.size()) {
+            buildHeap();
+        } else {
+            for (size_t i = oldSize; i < heap.size(); i++) {
+                heapifyUp(i);
+            }
+        }
+    }
+
+    // Drops every element for which pred returns true and re-heapifies,
+    // O(n) in total. Useful for compacting lazily deleted entries.
+    template <typename Pred>
+    void removeIf(Pred pred) {
+        heap.erase(std::remove_if(heap.begin(), heap.end(), pred), heap.end());
+        buildHeap();
+    }
+
+    // Sorts values ascending (by Compare) in place: heapify in O(n), then
+    // move the top to the end of a shrinking heap n - 1 times.
+    static void heapsort(std::vector<T>& values, const Compare& c = Compare()) {
+        MaxHeap h(c);
+        h.heap.swap(values);
+        h.buildHeap();
+        for (size_t end = h.heap.size(); end-- > 1;) {
+            std::swap(h.heap[0], h.heap[end]);
+            h.heapifyDown(0, end);
+        }
+        h.heap.swap(values);
+    }
+
+    void insert(const T& value) {
+        heap.push_back(value);
+        heapifyUp(heap.size() - 1);
+    }
+
+    void insert(T&& value) {
+        heap.push_back(std::move(value));
+        heapifyUp(heap.size() - 1);
+    }
+
+    template <typename... Args>
+    void emplace(Args&&... args) {
+        heap.emplace_back(std::forward<Args>(args)...);
+        heapifyUp(heap.size() - 1);
+    }
+
+    void removeMax() {
+        if (heap.empty()) {
+            return;
+        }
+
+        if (heap.size() > 1) {
+            heap[0] = std::move(heap.back());
+        }
+        heap.pop_back();
+        if (!heap.empty()) {
+            heapifyDown(0);
+        }
+    }
+
+    // Overwrites the top element and restores the heap: one sift down
+    // instead of a removeMax() followed by an insert().
+    void replaceMax(const T& value) {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+
+        heap[0] = value;
+        heapifyDown(0);
+    }
+
+    // Moves the top element out and removes it.
+    T extractMax() {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+
+        T top = std::move(heap[0]);
+        removeMax();
+        return top;
+    }
+
+    const T& getMax() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+
+        return heap[0];
+    }
+
+    bool isEmpty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    void clear() {
+        heap.clear();
+    }
+
+    void reserve(size_t n) {
+        heap.reserve(n);
+    }
+};
+
+#endif
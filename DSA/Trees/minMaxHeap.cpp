@@ -0,0 +1,197 @@
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <random>
+#include <set>
+
+// Min-max heap (double-ended priority queue) in a single array. Nodes on
+// even levels (root = level 0) are no larger than anything below them,
+// nodes on odd levels are no smaller. So the minimum is the root and the
+// maximum is one of its two children: both ends are O(1) to read and
+// O(log n) to remove, without keeping a second heap in sync.
+template <typename T, typename Compare = std::less<T>>
+class MinMaxHeap {
+private:
+    std::vector<T> heap;
+    Compare comp;
+
+    static bool isMaxLevel(size_t index) {
+        size_t level = 0;
+        for (size_t i = index + 1; i > 1; i >>= 1) {
+            level++;
+        }
+        return level % 2 == 1;
+    }
+
+    // On a min level "a before b" means a < b; on a max level a > b.
+    bool before(const T& a, const T& b, bool maxLevel) const {
+        return maxLevel ? comp(b, a) : comp(a, b);
+    }
+
+    // Moves index up through grandparents of its own kind.
+    void bubbleUpGrand(size_t index, bool maxLevel) {
+        while (index > 2) {
+            size_t grand = ((index - 1) / 2 - 1) / 2;
+            if (!before(heap[index], heap[grand], maxLevel)) {
+                break;
+            }
+            std::swap(heap[index], heap[grand]);
+            index = grand;
+        }
+    }
+
+    void bubbleUp(size_t index) {
+        if (index == 0) {
+            return;
+        }
+        bool maxLevel = isMaxLevel(index);
+        size_t parent = (index - 1) / 2;
+        if (before(heap[parent], heap[index], maxLevel)) {
+            // Belongs to the parent's kind of level.
+            std::swap(heap[index], heap[parent]);
+            bubbleUpGrand(parent, !maxLevel);
+        } else {
+            bubbleUpGrand(index, maxLevel);
+        }
+    }
+
+    void trickleDown(size_t index) {
+        bool maxLevel = isMaxLevel(index);
+        size_t n = heap.size();
+
+        while (2 * index + 1 < n) {
+            // Best of the up to 2 children and 4 grandchildren.
+            size_t best = 2 * index + 1;
+            size_t candidates[] = {2 * index + 2, 4 * index + 3, 4 * index + 4, 4 * index + 5, 4 * index + 6};
+            for (size_t c : candidates) {
+                if (c < n && before(heap[c], heap[best], maxLevel)) {
+                    best = c;
+                }
+            }
+
+            if (!before(heap[best], heap[index], maxLevel)) {
+                return;
+            }
+            std::swap(heap[best], heap[index]);
+
+            if (best <= 2 * index + 2) {
+                return;   // a child: it is on the opposite level, done
+            }
+
+            // A grandchild: the value that came down may violate the
+            // opposite-level order with the grandchild's parent.
+            size_t parent = (best - 1) / 2;
+            if (before(heap[parent], heap[best], maxLevel)) {
+                std::swap(heap[parent], heap[best]);
+            }
+            index = best;
+        }
+    }
+
+    size_t maxIndex() const {
+        if (heap.size() == 1) {
+            return 0;
+        }
+        if (heap.size() == 2 || comp(heap[2], heap[1])) {
+            return 1;
+        }
+        return 2;
+    }
+
+    void removeAt(size_t index) {
+        if (index + 1 < heap.size()) {
+            heap[index] = std::move(heap.back());
+        }
+        heap.pop_back();
+        if (index < heap.size()) {
+            trickleDown(index);
+        }
+    }
+
+public:
+    MinMaxHeap(const Compare& c = Compare()) : comp(c) {}
+
+    void reserve(size_t n) {
+        heap.reserve(n);
+    }
+
+    void insert(const T& value) {
+        heap.push_back(value);
+        bubbleUp(heap.size() - 1);
+    }
+
+    const T& getMin() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return heap[0];
+    }
+
+    const T& getMax() const {
+        if (heap.empty()) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return heap[maxIndex()];
+    }
+
+    void removeMin() {
+        if (!heap.empty()) {
+            removeAt(0);
+        }
+    }
+
+    void removeMax() {
+        if (!heap.empty()) {
+            removeAt(maxIndex());
+        }
+    }
+
+    bool isEmpty() const {
+        return heap.empty();
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+};
+
+int main() {
+    // Admission control: serve the most urgent, evict the least urgent.
+    MinMaxHeap<int> pq;
+    for (int p : {40, 15, 90, 5, 60, 25, 75, 10}) {
+        pq.insert(p);
+    }
+
+    std::cout << "Serve: " << pq.getMax() << std::endl;
+    pq.removeMax();
+    std::cout << "Evict: " << pq.getMin() << std::endl;
+    pq.removeMin();
+    std::cout << "Next max/min: " << pq.getMax() << " / " << pq.getMin() << std::endl;
+
+    // Randomised check against std::multiset.
+    MinMaxHeap<int> h;
+    std::multiset<int> ref;
+    std::mt19937 gen(9);
+    bool ok = true;
+    for (int i = 0; i < 200000 && ok; i++) {
+        int op = gen() % 4;
+        if (op < 2 || ref.empty()) {
+            int v = gen() % 1000;
+            h.insert(v);
+            ref.insert(v);
+        } else if (op == 2) {
+            ok = h.getMin() == *ref.begin();
+            h.removeMin();
+            ref.erase(ref.begin());
+        } else {
+            ok = h.getMax() == *ref.rbegin();
+            h.removeMax();
+            ref.erase(std::prev(ref.end()));
+        }
+    }
+    std::cout << (ok && h.size() == ref.size() ? "Matches multiset" : "MISMATCH") << std::endl;
+
+    return 0;
+}
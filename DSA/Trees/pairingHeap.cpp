@@ -0,0 +1,350 @@
+#include <iostream>
+#include <vector>
+#include <list>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <new>
+#include <string>
+
+// Pairing heap with the same insert/getMax/removeMax interface as MaxHeap
+// (maxHeap.h), for workloads that merge whole queues. Costs:
+//   insert, getMax             O(1)
+//   meld                       O(BlockSize), independent of the heap sizes
+//   increaseKey                O(1) amortized in practice (cut + link)
+//   removeMax, erase           O(log n) amortized
+// Nodes come from a per-heap pool of fixed-size blocks with an intrusive
+// free list. Slots are raw storage: a value is constructed when its node
+// is handed out and destroyed when the node is released, so T needs no
+// default constructor and a freed slot holds nothing alive. meld() splices
+// the other heap's blocks and free list into this one, so handles stay
+// valid after a merge; the only per-meld loop threads the unused tail of
+// the other heap's newest block (fewer than BlockSize slots) onto the free
+// list.
+template <typename T, typename Compare = std::less<T>>
+class PairingHeap {
+private:
+    struct Node {
+        alignas(T) unsigned char storage[sizeof(T)];   // the value, while in use
+        Node* child;     // leftmost child
+        Node* sibling;   // next sibling to the right (free list link when unused)
+        Node* prev;      // left sibling, or parent for a leftmost child
+
+        T& value() {
+            return *std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    static const size_t BlockSize = 256;
+
+    struct Block {
+        Node nodes[BlockSize];
+    };
+
+    std::list<Block> blocks;
+    size_t usedInLast;       // nodes handed out from the newest block
+    Node* freeHead;
+    Node* freeTail;
+
+    Node* root;
+    size_t n;
+    Compare comp;
+    std::vector<Node*> scratch;   // reused by removeMax
+
+    Node* allocate(const T& value) {
+        Node* node;
+        if (freeHead != nullptr) {
+            node = freeHead;
+            freeHead = freeHead->sibling;
+            if (freeHead == nullptr) {
+                freeTail = nullptr;
+            }
+        } else {
+            if (blocks.empty() || usedInLast == BlockSize) {
+                blocks.emplace_back();
+                usedInLast = 0;
+            }
+            node = &blocks.back().nodes[usedInLast++];
+        }
+        try {
+            new (node->storage) T(value);
+        } catch (...) {
+            pushFree(node);
+            throw;
+        }
+        node->child = node->sibling = node->prev = nullptr;
+        return node;
+    }
+
+    void release(Node* node) {
+        node->value().~T();
+        pushFree(node);
+    }
+
+    // Puts a slot that holds no value on the free list.
+    void pushFree(Node* node) {
+        node->prev = node->child = nullptr;
+        node->sibling = freeHead;
+        freeHead = node;
+        if (freeTail == nullptr) {
+            freeTail = node;
+        }
+    }
+
+    // Makes the loser of two roots the leftmost child of the winner.
+    Node* link(Node* a, Node* b) {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        if (comp(a->value(), b->value())) {
+            std::swap(a, b);
+        }
+        b->prev = a;
+        b->sibling = a->child;
+        if (a->child != nullptr) {
+            a->child->prev = b;
+        }
+        a->child = b;
+        a->sibling = a->prev = nullptr;
+        return a;
+    }
+
+    // Detaches a non-root node (with its subtree) from its parent/siblings.
+    void cut(Node* node) {
+        if (node->prev->child == node) {
+            node->prev->child = node->sibling;
+        } else {
+            node->prev->sibling = node->sibling;
+        }
+        if (node->sibling != nullptr) {
+            node->sibling->prev = node->prev;
+        }
+        node->sibling = node->prev = nullptr;
+    }
+
+    // Standard two-pass combine of a sibling list: link pairs left to
+    // right, then fold the results right to left.
+    Node* combine(Node* first) {
+        scratch.clear();
+        while (first != nullptr) {
+            Node* a = first;
+            Node* b = a->sibling;
+            first = b != nullptr ? b->sibling : nullptr;
+            a->sibling = a->prev = nullptr;
+            if (b != nullptr) {
+                b->sibling = b->prev = nullptr;
+            }
+            scratch.push_back(link(a, b));
+        }
+
+        Node* result = nullptr;
+        for (size_t i = scratch.size(); i-- > 0;) {
+            result = link(scratch[i], result);
+        }
+        return result;
+    }
+
+public:
+    typedef Node* Handle;
+
+    PairingHeap(const Compare& c = Compare())
+        : usedInLast(0), freeHead(nullptr), freeTail(nullptr),
+          root(nullptr), n(0), comp(c) {}
+
+    ~PairingHeap() {
+        // Destroy the live values; the blocks themselves go with the list.
+        std::vector<Node*> pending;
+        if (root != nullptr) {
+            pending.push_back(root);
+        }
+        while (!pending.empty()) {
+            Node* node = pending.back();
+            pending.pop_back();
+            for (Node* c = node->child; c != nullptr; c = c->sibling) {
+                pending.push_back(c);
+            }
+            node->value().~T();
+        }
+    }
+
+    // Handles point into the pool, so a heap is not copyable.
+    PairingHeap(const PairingHeap&) = delete;
+    PairingHeap& operator=(const PairingHeap&) = delete;
+
+    Handle insert(const T& value) {
+        Node* node = allocate(value);
+        root = link(root, node);
+        n++;
+        return node;
+    }
+
+    const T& getMax() const {
+        if (root == nullptr) {
+            throw std::out_of_range("Heap is empty");
+        }
+        return root->value();
+    }
+
+    void removeMax() {
+        if (root == nullptr) {
+            return;
+        }
+        Node* old = root;
+        root = combine(root->child);
+        release(old);
+        n--;
+    }
+
+    // Moves a node toward the top (its new value must not be worse).
+    void increaseKey(Handle h, const T& value) {
+        if (comp(value, h->value())) {
+            throw std::invalid_argument("increaseKey would lower the priority");
+        }
+        h->value() = value;
+        if (h != root) {
+            cut(h);
+            root = link(root, h);
+        }
+    }
+
+    void erase(Handle h) {
+        if (h == root) {
+            removeMax();
+            return;
+        }
+        cut(h);
+        Node* rest = combine(h->child);
+        root = link(root, rest);
+        release(h);
+        n--;
+    }
+
+    const T& value(Handle h) const {
+        return h->value();
+    }
+
+    // Moves all of other's elements into this heap without touching them.
+    // other is left empty; its handles now belong to this heap.
+    void meld(PairingHeap& other) {
+        if (&other == this) {
+            return;
+        }
+
+        root = link(root, other.root);
+        n += other.n;
+
+        // Keep our newest block last so usedInLast still describes it;
+        // the spare tail of other's last block goes onto the free list.
+        // With no blocks of our own, other's last block simply becomes
+        // ours, together with its usedInLast.
+        if (blocks.empty()) {
+            blocks.splice(blocks.begin(), other.blocks);
+            usedInLast = other.usedInLast;
+        } else if (!other.blocks.empty()) {
+            Block& last = other.blocks.back();
+            for (size_t i = other.usedInLast; i < BlockSize; i++) {
+                other.pushFree(&last.nodes[i]);
+            }
+            blocks.splice(blocks.begin(), other.blocks);
+        }
+        if (other.freeHead != nullptr) {
+            other.freeTail->sibling = freeHead;
+            freeHead = other.freeHead;
+            if (freeTail == nullptr) {
+                freeTail = other.freeTail;
+            }
+        }
+
+        other.root = nullptr;
+        other.n = 0;
+        other.usedInLast = 0;
+        other.freeHead = other.freeTail = nullptr;
+    }
+
+    bool isEmpty() const {
+        return root == nullptr;
+    }
+
+    size_t size() const {
+        return n;
+    }
+};
+
+// No default constructor: the pool only builds values it is given.
+struct Job {
+    std::string name;
+    int priority;
+
+    Job(const std::string& name, int priority) : name(name), priority(priority) {}
+
+    bool operator<(const Job& o) const {
+        return priority < o.priority;
+    }
+};
+
+int main() {
+    // Two per-worker queues consolidated into one.
+    PairingHeap<int> a, b;
+    for (int v : {10, 5, 7, 3, 12}) {
+        a.insert(v);
+    }
+    PairingHeap<int>::Handle h = b.insert(1);
+    for (int v : {9, 4, 15}) {
+        b.insert(v);
+    }
+
+    a.meld(b);
+    a.increaseKey(h, 20);   // handle from b is still valid after meld
+
+    std::cout << "Merged size: " << a.size() << ", b empty: " << b.isEmpty() << std::endl;
+    while (!a.isEmpty()) {
+        std::cout << a.getMax() << " ";
+        a.removeMax();
+    }
+    std::cout << std::endl;
+
+    // Melding into a heap that has never allocated, then growing it.
+    PairingHeap<int> empty, ten;
+    for (int i = 0; i < 10; i++) {
+        ten.insert(i);
+    }
+    empty.meld(ten);
+    for (int i = 10; i < 310; i++) {
+        empty.insert(i);
+    }
+    int popped = 0;
+    for (int expect = 309; !empty.isEmpty(); expect--, popped++) {
+        if (empty.getMax() != expect) {
+            std::cout << "Wrong order after meld!" << std::endl;
+            break;
+        }
+        empty.removeMax();
+    }
+    std::cout << "Popped " << popped << " of 310 after melding into an empty heap" << std::endl;
+
+    // Values without a default constructor; popped jobs free their
+    // strings right away rather than when the slot is reused.
+    PairingHeap<Job> jobs;
+    jobs.insert(Job("backup", 2));
+    jobs.insert(Job("deploy", 9));
+    PairingHeap<Job>::Handle report = jobs.insert(Job("report", 4));
+    jobs.increaseKey(report, Job("report (urgent)", 10));
+    std::cout << "Next job: " << jobs.getMax().name << std::endl;
+
+    // Min mode with a cancelled entry.
+    PairingHeap<int, std::greater<int>> m;
+    PairingHeap<int, std::greater<int>>::Handle cancel = m.insert(2);
+    for (int v : {8, 6, 11}) {
+        m.insert(v);
+    }
+    m.erase(cancel);
+    while (!m.isEmpty()) {
+        std::cout << m.getMax() << " ";
+        m.removeMax();
+    }
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include "maxHeap.h"
+
+// Radix heap: a min priority queue for monotone integer keys, i.e. no key
+// pushed is ever smaller than the last key popped (event simulation,
+// Dijkstra with non-negative weights). Bucket b holds the keys whose
+// highest bit that differs from the last popped key is bit b - 1; bucket 0
+// holds keys equal to it. Popping from an empty bucket 0 takes the first
+// non-empty bucket, makes its minimum the new "last" and redistributes the
+// rest into strictly lower buckets. Every element can only move down, so
+// each one is touched at most O(log C) times in total, and buckets are
+// plain vectors scanned sequentially. No comparisons between elements.
+template <typename V>
+class RadixHeap {
+private:
+    static const int Buckets = 65;
+
+    std::vector<std::pair<uint64_t, V>> bucket[Buckets];
+    uint64_t last;
+    size_t n;
+
+    static int bucketOf(uint64_t key, uint64_t last) {
+        uint64_t x = key ^ last;
+        return x == 0 ? 0 : 64 - __builtin_clzll(x);
+    }
+
+    // Refills bucket 0 from the lowest non-empty bucket.
+    void pull() {
+        if (!bucket[0].empty()) {
+            return;
+        }
+
+        int i = 1;
+        while (bucket[i].empty()) {
+            i++;
+        }
+
+        uint64_t newLast = bucket[i][0].first;
+        for (const std::pair<uint64_t, V>& e : bucket[i]) {
+            if (e.first < newLast) {
+                newLast = e.first;
+            }
+        }
+
+        last = newLast;
+        for (std::pair<uint64_t, V>& e : bucket[i]) {
+            bucket[bucketOf(e.first, last)].push_back(std::move(e));
+        }
+        bucket[i].clear();   // keeps its capacity for reuse
+    }
+
+public:
+    RadixHeap() : last(0), n(0) {}
+
+    void push(uint64_t key, const V& value) {
+        if (key < last) {
+            throw std::invalid_argument("RadixHeap keys must be monotone");
+        }
+        bucket[bucketOf(key, last)].emplace_back(key, value);
+        n++;
+    }
+
+    uint64_t topKey() {
+        if (n == 0) {
+            throw std::out_of_range("Heap is empty");
+        }
+        pull();
+        return last;
+    }
+
+    // Removes a minimum element and returns it.
+    std::pair<uint64_t, V> pop() {
+        if (n == 0) {
+            throw std::out_of_range("Heap is empty");
+        }
+        pull();
+        std::pair<uint64_t, V> top = std::move(bucket[0].back());
+        bucket[0].pop_back();
+        n--;
+        return top;
+    }
+
+    bool isEmpty() const {
+        return n == 0;
+    }
+
+    size_t size() const {
+        return n;
+    }
+};
+
+// Monotone workload shaped like Dijkstra / an event queue: keep `live`
+// elements queued; each pop pushes a new key a random distance ahead.
+struct ByKey {
+    bool operator()(const std::pair<uint64_t, uint32_t>& a,
+                    const std::pair<uint64_t, uint32_t>& b) const {
+        return a.first > b.first;
+    }
+};
+
+int main() {
+    const int live = 100000;
+    const int ops = 5000000;
+    const uint64_t maxStep = 1000;
+
+    std::mt19937_64 gen(7);
+    std::vector<uint64_t> steps(live + ops);
+    for (uint64_t& s : steps) {
+        s = gen() % maxStep;
+    }
+
+    uint64_t sumRadix = 0, sumHeap = 0;
+
+    auto t0 = std::chrono::steady_clock::now();
+    RadixHeap<uint32_t> rh;
+    for (int i = 0; i < live; i++) {
+        rh.push(steps[i], i);
+    }
+    for (int i = 0; i < ops; i++) {
+        std::pair<uint64_t, uint32_t> top = rh.pop();
+        sumRadix += top.first;
+        rh.push(top.first + steps[live + i], top.second);
+    }
+    auto t1 = std::chrono::steady_clock::now();
+
+    MaxHeap<std::pair<uint64_t, uint32_t>, ByKey> mh;
+    for (int i = 0; i < live; i++) {
+        mh.insert(std::make_pair(steps[i], (uint32_t)i));
+    }
+    for (int i = 0; i < ops; i++) {
+        std::pair<uint64_t, uint32_t> top = mh.extractMax();
+        sumHeap += top.first;
+        mh.insert(std::make_pair(top.first + steps[live + i], top.second));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+
+    auto ms = [](std::chrono::steady_clock::duration d) {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+    };
+
+    std::cout << ops << " pop+push pairs with " << live << " live keys" << std::endl;
+    std::cout << "RadixHeap: " << ms(t1 - t0) << " ms" << std::endl;
+    std::cout << "MaxHeap:   " << ms(t2 - t1) << " ms" << std::endl;
+    std::cout << (sumRadix == sumHeap ? "Same pop order" : "MISMATCH") << std::endl;
+
+    return 0;
+}
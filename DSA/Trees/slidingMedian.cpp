@@ -0,0 +1,193 @@
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "maxHeap.h"
+
+// Rolling percentile over the last `window` samples with two heaps:
+// lower holds the smallest r samples (max on top) and upper the rest
+// (min on top), where r is the nearest rank of the tracked percentile.
+// The answer is therefore always lower.getMax(), O(1) to read.
+//
+// Samples leaving the window are deleted lazily: they are counted in a
+// pending map and only physically removed when they reach the top of
+// their heap. When stale entries make up more than half of a heap it is
+// compacted in O(n) with removeIf, so memory stays O(window).
+// Each update is O(log window) amortized.
+template <typename T>
+class SlidingPercentile {
+private:
+    MaxHeap<T> lower;
+    MaxHeap<T, std::greater<T>> upper;
+    std::unordered_map<T, int> staleLower, staleUpper;
+    size_t lowerCount, upperCount;   // live elements per heap
+    std::deque<T> samples;
+    size_t window;
+    double percentile;
+
+    size_t targetRank() const {
+        size_t n = lowerCount + upperCount;
+        size_t r = (size_t)std::ceil(percentile * n);
+        return n == 0 ? 0 : std::max<size_t>(r, 1);
+    }
+
+    template <typename Heap>
+    static void prune(Heap& heap, std::unordered_map<T, int>& stale) {
+        while (!heap.isEmpty()) {
+            auto it = stale.find(heap.getMax());
+            if (it == stale.end()) {
+                return;
+            }
+            if (--it->second == 0) {
+                stale.erase(it);
+            }
+            heap.removeMax();
+        }
+    }
+
+    template <typename Heap>
+    static void compact(Heap& heap, std::unordered_map<T, int>& stale, size_t live) {
+        if (heap.size() <= 2 * live + 32) {
+            return;
+        }
+        heap.removeIf([&stale](const T& v) {
+            auto it = stale.find(v);
+            if (it == stale.end()) {
+                return false;
+            }
+            if (--it->second == 0) {
+                stale.erase(it);
+            }
+            return true;
+        });
+    }
+
+    void erase(const T& value) {
+        if (lowerCount > 0 && !(lower.getMax() < value)) {
+            staleLower[value]++;
+            lowerCount--;
+            prune(lower, staleLower);
+            compact(lower, staleLower, lowerCount);
+        } else {
+            staleUpper[value]++;
+            upperCount--;
+            prune(upper, staleUpper);
+            compact(upper, staleUpper, upperCount);
+        }
+    }
+
+    void rebalance() {
+        size_t r = targetRank();
+        while (lowerCount > r) {
+            upper.insert(lower.extractMax());
+            lowerCount--;
+            upperCount++;
+            prune(lower, staleLower);
+        }
+        while (lowerCount < r) {
+            lower.insert(upper.extractMax());
+            upperCount--;
+            lowerCount++;
+            prune(upper, staleUpper);
+        }
+    }
+
+public:
+    SlidingPercentile(size_t window, double percentile = 0.5)
+        : lowerCount(0), upperCount(0), window(window), percentile(percentile) {
+        if (window == 0 || percentile <= 0 || percentile > 1) {
+            throw std::invalid_argument("Bad window or percentile");
+        }
+    }
+
+    void add(const T& value) {
+        if (lowerCount == 0 || !(lower.getMax() < value)) {
+            lower.insert(value);
+            lowerCount++;
+        } else {
+            upper.insert(value);
+            upperCount++;
+        }
+
+        samples.push_back(value);
+        if (samples.size() > window) {
+            erase(samples.front());
+            samples.pop_front();
+        }
+        rebalance();
+    }
+
+    // Nearest-rank percentile of the current window.
+    const T& value() const {
+        if (lowerCount == 0) {
+            throw std::out_of_range("Window is empty");
+        }
+        return lower.getMax();
+    }
+
+    // For a 0.5 tracker: the usual median, averaging the two middle
+    // samples when the window holds an even number of them.
+    double median() const {
+        if ((lowerCount + upperCount) % 2 == 0 && upperCount > 0) {
+            return ((double)lower.getMax() + (double)upper.getMax()) / 2;
+        }
+        return (double)value();
+    }
+
+    size_t size() const {
+        return samples.size();
+    }
+
+    // Physical heap sizes, including not yet compacted stale entries.
+    size_t heapSize() const {
+        return lower.size() + upper.size();
+    }
+};
+
+int main() {
+    const size_t window = 1001;
+    SlidingPercentile<int> p50(window), p90(window, 0.90), p99(window, 0.99);
+
+    std::mt19937 gen(5);
+    std::lognormal_distribution<double> latency(3.0, 0.6);
+    std::deque<int> check;
+    size_t maxHeapSize = 0;
+    bool ok = true;
+
+    for (int i = 0; i < 200000; i++) {
+        int sample = (int)latency(gen);
+        p50.add(sample);
+        p90.add(sample);
+        p99.add(sample);
+        maxHeapSize = std::max(maxHeapSize, p50.heapSize());
+
+        // Re-sort the window now and then to verify the trackers.
+        check.push_back(sample);
+        if (check.size() > window) {
+            check.pop_front();
+        }
+        if (i % 997 == 0) {
+            std::vector<int> sorted(check.begin(), check.end());
+            std::sort(sorted.begin(), sorted.end());
+            size_t n = sorted.size();
+            auto rank = [n](double p) {
+                return std::max<size_t>((size_t)std::ceil(p * n), 1) - 1;
+            };
+            ok = ok && p50.value() == sorted[rank(0.5)]
+                    && p90.value() == sorted[rank(0.90)]
+                    && p99.value() == sorted[rank(0.99)];
+        }
+    }
+
+    std::cout << "p50 = " << p50.median() << ", p90 = " << p90.value()
+              << ", p99 = " << p99.value() << std::endl;
+    std::cout << "Largest heap footprint: " << maxHeapSize << " for a window of " << window << std::endl;
+    std::cout << (ok ? "Matches sorted window" : "MISMATCH") << std::endl;
+
+    return 0;
+}
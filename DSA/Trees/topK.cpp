@@ -0,0 +1,123 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include "maxHeap.h"
+
+// Keeps the k largest items of a stream of any length in O(k) memory.
+// The candidates sit in a size-k min heap whose top is the current
+// threshold: anything not better than it is rejected with one comparison
+// and never touches the heap; anything better replaces the top with a
+// single sift down. Independent TopK objects (one per thread) can be
+// merged afterwards.
+template <typename T, typename Compare = std::less<T>>
+class TopK {
+private:
+    struct Reversed {
+        Compare comp;
+        bool operator()(const T& a, const T& b) const {
+            return comp(b, a);
+        }
+    };
+
+    size_t k;
+    MaxHeap<T, Reversed, 4> heap;   // top = smallest of the kept items
+    Compare comp;
+
+public:
+    TopK(size_t k, const Compare& c = Compare())
+        : k(k), heap(Reversed{c}), comp(c) {
+        heap.reserve(k);
+    }
+
+    void offer(const T& value) {
+        if (heap.size() < k) {
+            heap.insert(value);
+        } else if (k > 0 && comp(heap.getMax(), value)) {
+            heap.replaceMax(value);
+        }
+    }
+
+    template <typename It>
+    void offer(It first, It last) {
+        for (; first != last; ++first) {
+            offer(*first);
+        }
+    }
+
+    // Folds another partial result into this one; other is consumed.
+    void merge(TopK& other) {
+        while (!other.heap.isEmpty()) {
+            offer(other.heap.extractMax());
+        }
+    }
+
+    // Smallest value that is currently kept (meaningful once full()).
+    const T& threshold() const {
+        return heap.getMax();
+    }
+
+    bool full() const {
+        return heap.size() == k;
+    }
+
+    size_t size() const {
+        return heap.size();
+    }
+
+    // The kept items, best first. Does not modify the tracker.
+    std::vector<T> results() const {
+        MaxHeap<T, Reversed, 4> copy = heap;
+        std::vector<T> out(copy.size());
+        for (size_t i = out.size(); i-- > 0;) {
+            out[i] = copy.extractMax();
+        }
+        return out;
+    }
+};
+
+int main() {
+    const int threads = 4;
+    const size_t k = 10;
+    const int perThread = 5000000;
+
+    std::vector<TopK<int>> partial(threads, TopK<int>(k));
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; t++) {
+        workers.emplace_back([&, t]() {
+            std::mt19937 gen(t);
+            for (int i = 0; i < perThread; i++) {
+                partial[t].offer((int)(gen() % 1000000000));
+            }
+        });
+    }
+    for (std::thread& w : workers) {
+        w.join();
+    }
+
+    TopK<int> top(k);
+    for (TopK<int>& p : partial) {
+        top.merge(p);
+    }
+
+    std::cout << "Top " << k << " of " << threads * perThread << ":";
+    for (int v : top.results()) {
+        std::cout << " " << v;
+    }
+    std::cout << std::endl;
+
+    // Same stream, brute force, to check the answer.
+    std::vector<int> all;
+    for (int t = 0; t < threads; t++) {
+        std::mt19937 gen(t);
+        for (int i = 0; i < perThread; i++) {
+            all.push_back((int)(gen() % 1000000000));
+        }
+    }
+    std::partial_sort(all.begin(), all.begin() + k, all.end(), std::greater<int>());
+    all.resize(k);
+    std::cout << (all == top.results() ? "Matches full sort" : "MISMATCH") << std::endl;
+
+    return 0;
+}